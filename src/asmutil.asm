@@ -110,161 +110,406 @@ _asmutil_CopyData:
 
 ; -----------------------------------------------------------------------------
 
-_find_phrase:
+  public _asmutil_FindPhrase
+_asmutil_FindPhrase:
 ; Arguments:
 ;   arg0 == start address
 ;   arg1 == end address
-;   arg2 == phrase
+;   arg2 -> phrase
 ;   arg3 == phrase length
+;   arg4 -> pointer array for match pointers
+;   arg5 == number of match pointers allowed
 ; Returns:
-;   HL == pointer to first match found
-;   Carry flag set if match found; reset if no match found
+;   A == number of matches found
 ; Destroys:
-;   A, BC, DE, IY
+;   BC, DE, HL, IY
+; Notes:
+;   Boyer-Moore-Horspool search. The byte under the last phrase byte is
+;   compared first. If the rest of the phrase does not match, the search moves
+;   ahead by the distance from that byte's last occurance in the phrase
+;   (excluding its last byte) to the phrase's end, or by the whole phrase
+;   length if the byte does not occur in it.
 
 
-  ld	  iy,0
-  add	  iy,sp
-  ld	  bc,(iy + 3)
-  ld	  hl,(iy + 6)
-  push	hl
+  ld    iy,0
+  add   iy,sp
 
-; If start > end, exit
-  push  hl
+  ld    hl,(iy + 15)
+  ld    (.matchPtr),hl
+  ld    a,(iy + 18)
+  ld    (.maxMatches),a
   xor   a,a
-  sbc   hl,bc
-  pop   hl
-  jr    nc,.cont
-  xor   a,a             ; Reset carry flag
-  pop   hl
-  ret
-
-.cont:
-  ld    de,0            ; E = phrase offset
+  ld    (.numMatchesFound),a
 
-.compare:
-  ld    a,(bc)
+  ld    de,0
+  ld    e,(iy + 12)     ; DE == phrase length
+  ld    (.phraseLength),de
+  dec   de
+  ld    (.lengthMinusOne),de
   ld    hl,(iy + 9)
+  ld    (.phrase),hl
   add   hl,de
-  cp    a,(hl)
-  jr    z,.match
+  ld    a,(hl)
+  ld    (.lastByte),a
 
-; Comparison failed:
-  ld    e,0             ; Reset phrase offset
+; Every byte skips the whole phrase length by default
+  ld    hl,_skip_table
+  ld    a,(iy + 12)
+  ld    (hl),a
+  push  hl
+  pop   de
+  inc   de
+  ld    bc,255
+  ldir
 
-; If end of range reached, exit
-.endCheck:
-  pop   hl
+; Phrase byte i (excluding the last) skips (length - 1 - i) bytes. Later
+; occurances overwrite earlier ones.
+  ld    hl,(iy + 9)
+  ld    b,(iy + 12)
+  dec   b
+  jr    z,.tableDone
+.fillTable:
+  ld    de,0
+  ld    e,(hl)
   push  hl
-  xor   a,a
+  ld    hl,_skip_table
+  add   hl,de
+  ld    (hl),b
+  pop   hl
+  inc   hl
+  djnz  .fillTable
+.tableDone:
+
+; If the range is shorter than the phrase, exit
+  ld    de,(.lengthMinusOne)
+  ld    hl,(iy + 6)
+  ld    bc,(iy + 3)
+  or    a,a
   sbc   hl,bc
-  jr    z,.exitFast     ; Carry flag is still reset if Z is set
+  sbc   hl,de
+  jr    c,.finish
+
+; The last address a match can start at
+  ld    hl,(iy + 6)
+  or    a,a
+  sbc   hl,de
+  ld    (.lastStart),hl
 
-  inc   bc              ; Increment current address
-  jr    .compare
+  ld    hl,(iy + 3)     ; HL == current address
 
-.match:
-  inc   e               ; Increment phrase offset counter
-  ld    a,(iy + 12)
-  xor   a,e
-  jr    nz,.endCheck
+.search:
+; If the last possible match start has been passed, exit
+  ld    de,0
+.lastStart:=$-3
+  ex    de,hl
+  or    a,a
+  sbc   hl,de
+  jr    c,.finish
+  ex    de,hl
+
+; Compare the byte under the last phrase byte
+  ld    bc,0
+.lengthMinusOne:=$-3
+  push  hl
+  add   hl,bc
+  ld    a,(hl)
+  pop   hl
+  cp    a,0
+.lastByte:=$-1
+  jr    z,.checkRest
+
+.skip:
+; A == byte under the last phrase byte
+  ld    de,0
+  ld    e,a
+  push  hl
+  ld    hl,_skip_table
+  add   hl,de
+  ld    e,(hl)
+  pop   hl
+  add   hl,de
+  jr    c,.finish       ; The end of the address space was passed
+  jr    .search
+
+.checkRest:
+  ld    a,(.lengthMinusOne)
+  or    a,a
+  jr    z,.found
+  ld    b,a
+  push  hl
+  ld    de,0
+.phrase:=$-3
+.compareRest:
+  ld    a,(de)
+  cp    a,(hl)
+  jr    nz,.mismatch
+  inc   hl
+  inc   de
+  djnz  .compareRest
+  pop   hl
+  jr    .found
 
-; Full match found:
-  push  bc
+.mismatch:
   pop   hl
-  dec   e
-  sbc   hl,de           ; Carry reset by XOR A,E
-  scf                   ; We found a match
-.exitFast:
-  pop   bc              ; Remove the stack local
+  ld    a,(.lastByte)
+  jr    .skip
+
+.found:
+; Check for room in the match array
+  ld    a,0
+.numMatchesFound:=$-1
+  cp    a,0
+.maxMatches:=$-1
+  jr    z,.finish
+  inc   a
+  ld    (.numMatchesFound),a
+
+; Write new match address to array
+  ex    de,hl
+  ld    hl,0
+.matchPtr:=$-3
+  ld    (hl),de
+  inc   hl
+  inc   hl
+  inc   hl
+  ld    (.matchPtr),hl
+  ex    de,hl
+
+; Searching resumes after the match
+  ld    de,0
+.phraseLength:=$-3
+  add   hl,de
+  jr    c,.finish       ; The end of the address space was passed
+  jr    .search
+
+.finish:
+  ld    a,(.numMatchesFound)
   ret
 
 ; -----------------------------------------------------------------------------
 
-  public _asmutil_FindPhrase
-_asmutil_FindPhrase:
+  public _asmutil_FindMaskedPhrase
+_asmutil_FindMaskedPhrase:
 ; Arguments:
 ;   arg0 == start address
 ;   arg1 == end address
 ;   arg2 -> phrase
-;   arg3 == phrase length
-;   arg4 -> pointer array for match pointers
-;   arg5 == number of match pointers allowed
+;   arg3 -> mask
+;   arg4 == phrase length
+;   arg5 -> pointer array for match pointers
+;   arg6 == number of match pointers allowed
 ; Returns:
 ;   A == number of matches found
 ; Destroys:
 ;   BC, DE, HL, IY
+; Notes:
+;   The same Boyer-Moore-Horspool search as _asmutil_FindPhrase, except that
+;   a byte matches a phrase byte if it equals it after being ANDed with the
+;   mask byte. Every byte value a phrase byte can match gets a skip table
+;   entry, so wildcards shorten the skips.
 
 
   ld    iy,0
   add   iy,sp
+
+  ld    hl,(iy + 18)
+  ld    (.matchPtr),hl
+  ld    a,(iy + 21)
+  ld    (.maxMatches),a
+  xor   a,a
+  ld    (.numMatchesFound),a
+
+  ld    de,0
+  ld    e,(iy + 15)     ; DE == phrase length
+  ld    (.phraseLength),de
+  dec   de
+  ld    (.lengthMinusOne),de
+  ld    hl,(iy + 9)
+  ld    (.phrase),hl
+  add   hl,de
+  ld    a,(hl)
+  ld    (.lastByte),a
   ld    hl,(iy + 12)
+  ld    (.mask),hl
+  add   hl,de
+  ld    a,(hl)
+  ld    (.lastMask),a
+
+; Every byte skips the whole phrase length by default
+  ld    hl,_skip_table
+  ld    a,(iy + 15)
+  ld    (hl),a
   push  hl
+  pop   de
+  inc   de
+  ld    bc,255
+  ldir
+
+; Every byte value that phrase byte i (excluding the last) matches skips
+; (length - 1 - i) bytes. Later occurances overwrite earlier ones.
   ld    hl,(iy + 9)
+  ld    de,(iy + 12)
+  ld    b,(iy + 15)
+  dec   b
+  jr    z,.tableDone
+.fillTable:
+  ld    a,(hl)
+  ld    (.fillByte),a
+  ld    a,(de)
+  ld    (.fillMask),a
   push  hl
+  push  de
+  inc   a
+  jr    nz,.fillMasked
+
+; An unmasked phrase byte only matches itself
+  ld    de,0
+  ld    e,(hl)
+  ld    hl,_skip_table
+  add   hl,de
+  ld    (hl),b
+  jr    .fillNext
+
+.fillMasked:
+  ld    hl,_skip_table
+  ld    c,0             ; C == byte value
+.fillValue:
+  ld    a,c
+  and   a,0
+.fillMask:=$-1
+  cp    a,0
+.fillByte:=$-1
+  jr    nz,.fillSkip
+  ld    (hl),b
+.fillSkip:
+  inc   hl
+  inc   c
+  jr    nz,.fillValue
+
+.fillNext:
+  pop   de
+  pop   hl
+  inc   hl
+  inc   de
+  djnz  .fillTable
+.tableDone:
+
+; If the range is shorter than the phrase, exit
+  ld    de,(.lengthMinusOne)
   ld    hl,(iy + 6)
-  push  hl
+  ld    bc,(iy + 3)
+  or    a,a
+  sbc   hl,bc
+  sbc   hl,de
+  jr    c,.finish
 
-  ld    hl,(iy + 15)    ; HL -> match pointer array
-  ld    bc,0
-.lastMatchInArray:=$-3
-  ld    (.lastMatchInArray),hl
-  ld    bc,0
-  ld    c,(iy + 18)     ; C  == max number of match pointers
-  ld    b,3             ; 3 bytes is the size of a pointer
-  mlt   bc
-  add   hl,bc
-  ld    bc,0
-.endOfArray:=$-3
-  ld    (.endOfArray),hl
-  ld    a,0
-.numMatchesFound:=$-1
-  xor   a,a
-  ld    (.numMatchesFound),a
+; The last address a match can start at
+  ld    hl,(iy + 6)
+  or    a,a
+  sbc   hl,de
+  ld    (.lastStart),hl
 
-  ld  hl,(iy + 3)
+  ld    hl,(iy + 3)     ; HL == current address
 
-.compare:
-  push  hl            ; HL == start address
-  call  _find_phrase
-  pop   bc
+.search:
+; If the last possible match start has been passed, exit
+  ld    de,0
+.lastStart:=$-3
+  ex    de,hl
+  or    a,a
+  sbc   hl,de
+  jr    c,.finish
+  ex    de,hl
+
+; Compare the byte under the last phrase byte, keeping it in C for the skip
+  ld    bc,0
+.lengthMinusOne:=$-3
   push  hl
+  add   hl,bc
+  ld    a,(hl)
+  pop   hl
+  ld    c,a
+  and   a,0
+.lastMask:=$-1
+  cp    a,0
+.lastByte:=$-1
+  jr    z,.checkRest
+
+.skip:
+; C == byte under the last phrase byte
+  ld    de,0
+  ld    e,c
+  push  hl
+  ld    hl,_skip_table
+  add   hl,de
+  ld    e,(hl)
+  pop   hl
+  add   hl,de
+  jr    c,.finish       ; The end of the address space was passed
+  jr    .search
+
+.checkRest:
+  ld    a,(.lengthMinusOne)
+  or    a,a
+  jr    z,.found
+  ld    b,a
+  push  hl
+  ld    de,0
+.phrase:=$-3
+  ld    iy,0
+.mask:=$-3
+.compareRest:
+  ld    a,(hl)
+  and   a,(iy + 0)
+  ex    de,hl
+  cp    a,(hl)
+  ex    de,hl
+  jr    nz,.mismatch
+  inc   hl
+  inc   de
+  inc   iy
+  djnz  .compareRest
+  pop   hl
+  jr    .found
 
-; If _find_phrase does not return a match, exit
-  sbc   hl,hl           ; If carry flag is reset, this will not set it again
-  jr    nc,.finish
+.mismatch:
+  pop   hl
+  jr    .skip
 
+.found:
 ; Check for room in the match array
-  ld    hl,(.endOfArray)
-  ld    de,(.lastMatchInArray)
-  xor   a,a
-  sbc   hl,de
+  ld    a,0
+.numMatchesFound:=$-1
+  cp    a,0
+.maxMatches:=$-1
   jr    z,.finish
-
-; Increment numMatchesFound
-  ld    a,(.numMatchesFound)
   inc   a
   ld    (.numMatchesFound),a
 
 ; Write new match address to array
   ex    de,hl
-  pop   de              ; DE == _find_phrase return value
+  ld    hl,0
+.matchPtr:=$-3
   ld    (hl),de
   inc   hl
   inc   hl
   inc   hl
-  ld    (.lastMatchInArray),hl
+  ld    (.matchPtr),hl
+  ex    de,hl
 
-; Add phrase length to new match address to get new start address
-  ld    hl,0
-  ld    l,(iy + 12)
+; Searching resumes after the match
+  ld    de,0
+.phraseLength:=$-3
   add   hl,de
-  jr    .compare
+  jr    c,.finish       ; The end of the address space was passed
+  jr    .search
 
 .finish:
-  pop   hl            ; _find_phrase return value
-  pop   hl            ; phrase length
-  pop   hl            ; phrase
-  pop   hl            ; end address
   ld    a,(.numMatchesFound)
   ret
+
+
+section .bss
+
+_skip_table:
+  rb    256
@@ -94,4 +94,22 @@ uint8_t asmutil_FindPhrase(
 );
 
 
+// Description: Same as asmutil_FindPhrase(), except that a byte matches a
+//              phrase byte if ANDing it with the corresponding byte of <mask>
+//              gives the phrase byte. Clear mask bits are wildcards.
+// Pre:         Same as asmutil_FindPhrase().
+//              <mask> must be <length> bytes long, and every phrase byte
+//              must already be ANDed with its mask byte.
+// Post:        Same as asmutil_FindPhrase().
+uint8_t asmutil_FindMaskedPhrase(
+  const uint8_t* start,
+  const uint8_t* end,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t matches[],
+  uint8_t max_matches
+);
+
+
 #endif
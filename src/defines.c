@@ -73,6 +73,14 @@ const char* G_HEX_ASCII_KEYMAP[7] = {
   "\0\0\0\0"
 };
 
+// Same as G_HEX_ASCII_KEYMAP, with [(-)] (alpha "?" on the keypad) entering a
+// wildcard nibble.
+const char* G_HEX_PATTERN_KEYMAP[7] = {
+  "\0\0\0\0\0\0\0\0", "\0\0\0\0\0da\0", "\x30\x31\x34\x37\0eb\0",
+  "\0\x32\x35\x38\0fc\0", "?\x33\x36\x39\0\0\0\0", "\0\0\0\0\0\0\0\0",
+  "\0\0\0\0"
+};
+
 
 s_color g_color = {
   .bar = DK_GRAY,
@@ -59,6 +59,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define G_RECENTS_APPVAR_NAME     ("HXAEDITr")
 #define G_RECENTS_APPVAR_SIZE     (255)
 
+// A tab editing a variable in place mirrors its undo records into a journal, so
+// the edits can still be undone if HexaEdit does not exit normally. Each
+// journal's number replaces the last character of this name.
+#define G_JOURNAL_APPVAR_NAME     ("HXAEDIT0")
+
+// A tab keeps the old bytes of its larger undo records in a spill appvar, so
+// they do not take up the undo stack. Each spill appvar's number replaces the
+// last character of this name.
+#define G_SPILL_APPVAR_NAME       ("HXAEDIS0")
+
+// Every appvar above starts with this prefix, and they are hidden from the
+// variable lists.
+#define G_INTERNAL_APPVAR_PREFIX  ("HXAEDI")
+
+// The signatures that the editor finds all at once are read from this appvar.
+#define G_SIGNATURES_APPVAR_NAME  ("HXAESIGS")
+
+// The edit buffer holds a resized variable plus at least this many bytes of
+// room for insertions.
+#define G_EDIT_BUFFER_HEADROOM    (1024)
+
+// The edit buffer and the undo stack are shared by at most this many tabs.
+#define G_MAX_NUM_TABS            (4)
+
 #define G_FONT_HEIGHT         (7)
 #define G_ROWS_ONSCREEN       (18)
 #define G_COLS_ONSCREEN       (8)
@@ -74,12 +98,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define G_PORTS_SIZE          (0x200000)
 
 #define min(x, y) ((x > y ? y : x))
+#define max(x, y) ((x > y ? x : y))
 
 extern const char* G_UPPERCASE_LETTERS_KEYMAP[7];
 extern const char* G_LOWERCASE_LETTERS_KEYMAP[7];
 extern const char* G_DIGITS_KEYMAP[7];
 extern const char* G_HEX_NIBBLES_KEYMAP[7];
 extern const char* G_HEX_ASCII_KEYMAP[7];
+extern const char* G_HEX_PATTERN_KEYMAP[7];
 
 
 // <access_type> can have three values:
@@ -94,6 +120,19 @@ extern const char* G_HEX_ASCII_KEYMAP[7];
 //   'a': lowercase letters
 //   '0': numbers
 //   'x': hexadecimal characters
+// <near_size> and <far_size> split the data at the cursor: the cursor is on
+// the last byte of the near segment. <gap_offset> is the number of data bytes
+// physically stored at the start of the edit buffer; the remaining bytes are
+// stored at its end. The two splits are independent, so moving the cursor
+// never copies data.
+// If <paged> is set, the variable has not been resized yet: unmodified bytes
+// are read straight from <var_data>, and only modified pages are copied into
+// the edit buffer. If <in_place> is also set, the variable is in RAM and
+// every modification is written straight into <var_data>; discarding changes
+// undoes them.
+// <num_changes> counts the changes that can be undone. <undo_evicted> is set
+// once the oldest changes have been evicted from the undo stack to make room
+// for new ones, which leaves them unsaved but no longer undoable.
 typedef struct
 {
   char name[G_EDITOR_NAME_MAX_LEN];
@@ -103,6 +142,7 @@ typedef struct
   uint8_t tios_var_type;
   bool undo_buffer_active;
   uint24_t num_changes;
+  bool undo_evicted;
 
   uint8_t* base_address;
   uint24_t data_size;
@@ -115,6 +155,10 @@ typedef struct
 
   uint24_t near_size;
   uint24_t far_size;
+  uint24_t gap_offset;
+  bool paged;
+  bool in_place;
+  uint8_t* var_data;
   uint8_t selection_size;
   bool selection_active;
   bool high_nibble;
@@ -54,13 +54,103 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "tools.h"
 
 
+// The Find prompt searches for the phrase as it is typed, this many bytes at a
+// time between keypresses, and keeps up to MAX_NUM_LIVE_MATCHES matches.
+#define LIVE_FIND_SLICE_SIZE (16384)
+#define MAX_NUM_LIVE_MATCHES (64)
+
+// The size of a TI real: its sign, its exponent, and 14 BCD digits.
+#define TI_REAL_SIZE (9)
+
+// A value is searched for as six integers and one TI real, each of which is
+// preceded by its length as a signature.
+#define MAX_NUM_VALUE_SIGNATURES (7)
+#define MAX_VALUE_SIGNATURES_SIZE \
+  (2 * (2 + 3 + 4) + TI_REAL_SIZE + MAX_NUM_VALUE_SIGNATURES)
+
+
+// Reasons that run_editor() returns.
+enum EDITOR_EXIT_CODES : uint8_t
+{
+  EDITOR_CLOSE_TAB,
+  EDITOR_SWITCH_TAB,
+  EDITOR_OPEN_TAB
+};
+
+
+// The search for the phrase being typed into the Find prompt. It starts at
+// <start>, the cursor, and wraps around to the start of the data. <offset> is
+// where it goes on from. <matches> holds the first matches in that order, which
+// are all of them if <num_matches> is at most MAX_NUM_LIVE_MATCHES. A phrase
+// with a <length> of zero is too short to search for.
+typedef struct
+{
+  uint8_t phrase[8];
+  uint8_t mask[8];
+  uint8_t length;
+  bool masked;
+  uint24_t matches[MAX_NUM_LIVE_MATCHES];
+  uint24_t num_matches;
+  uint24_t start;
+  uint24_t offset;
+  bool wrapped;
+  bool finished;
+} s_live_find;
+
+
+// File globals. Do NOT use these outside of this file.
+// The editor of each open tab. The active tab is edited through the editor
+// passed in by the caller, so its entry is only up to date while another tab
+// is active.
+static s_editor g_tab_editors[G_MAX_NUM_TABS];
+
+// A variable opened from a search of every variable starts in the find viewer
+// with this phrase.
+static const uint8_t* g_open_phrase = NULL;
+static const uint8_t* g_open_mask = NULL;
+static uint8_t g_open_phrase_length = 0;
+
+static s_live_find g_live_find;
+
+
 // =============================================================================
 // STATIC FUNCTION DECLARATIONS
 // =============================================================================
 
 
+// Description: Saves the active tab's editor and opens a new tab.
+// Post:        If successful, true returned.
+static bool open_tab(s_editor* const editor);
+
+
+// Description: Closes the active tab. If any tabs are left, <editor> becomes
+//              the editor of the new active tab.
+static void close_tab(s_editor* const editor);
+
+
+// Description: Saves the active tab's editor and makes <tab> active.
+static void switch_tab(s_editor* const editor, const uint8_t tab);
+
+
+// Description: Returns the index of the tab that is editing the named memory,
+//              or tool_NumTabs() if there is none.
+static uint8_t find_tab(
+  const s_editor* const editor,
+  const char* const name,
+  const uint8_t name_length,
+  const bool is_tios_var,
+  const uint8_t tios_var_type
+);
+
+
+// Description: Runs the active tab's editor until every tab is closed or the
+//              user leaves to open another tab.
+static void run_tabs(s_editor* const editor);
+
+
 // Description: Handles the editor's main loop.
-static void run_editor(s_editor* const editor);
+// Post:        One of EDITOR_EXIT_CODES returned.
+static uint8_t run_editor(s_editor* const editor);
 
 
 static void goto_prompt(s_editor* const editor);
@@ -69,17 +159,116 @@ static void goto_prompt(s_editor* const editor);
 static void insert_bytes_prompt(s_editor* const editor);
 
 
+// Description: Converts the hexadecimal characters in <ascii_buffer> into
+//              bytes. A "?" is a wildcard nibble, which is cleared in both
+//              <nibble_buffer> and <mask_buffer>.
+// Post:        True returned if there were any wildcards.
+static bool ascii_to_nibble(
+  const char* ascii_buffer, uint8_t* nibble_buffer, uint8_t* mask_buffer
+);
+
+
+// Description: Converts the text typed into the Find prompt into a phrase. An
+//              odd number of hexadecimal characters ends in a wildcard nibble.
+// Post:        True returned if the text is long enough to search for.
+static bool live_find_phrase(
+  const char* const buffer,
+  const bool hex,
+  uint8_t phrase[8],
+  uint8_t mask[8],
+  uint8_t* const length,
+  bool* const masked
+);
+
+
+// Description: Starts searching for <phrase>. If it only matches where the
+//              phrase that was searched for before matches, and all of those
+//              matches are known, they are narrowed down instead of searching
+//              the data again.
+static void live_find_update(
+  const s_editor* const editor,
+  const uint8_t phrase[8],
+  const uint8_t mask[8],
+  const uint8_t length,
+  const bool masked
+);
+
+
+// Description: Searches the next LIVE_FIND_SLICE_SIZE bytes for the phrase
+//              being typed.
+// Pre:         <g_live_find> must have a phrase and be unfinished.
+static void live_find_step(const s_editor* const editor);
+
+
+// Description: Tells if the data has a match of <phrase> at <offset>.
+static bool live_find_match(
+  const s_editor* const editor,
+  const uint24_t offset,
+  const uint8_t phrase[8],
+  const uint8_t mask[8],
+  const uint8_t length
+);
+
+
+// Description: Replaces every match of <phrase>, or only the ones from <match>
+//              on, with a replacement that the user enters.
+// Post:        True returned if the user chose to replace, whether or not the
+//              replacement was made.
+static bool replace_prompt(
+  s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t phrase_length,
+  const uint24_t match
+);
+
+
 static void find_viewer(
   s_editor* const editor,
-  const uint24_t matches[],
-  const uint8_t num_matches,
-  const uint8_t phrase_length
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t phrase_length,
+  uint24_t match
 );
 
 
 static void find_prompt(s_editor* const editor);
 
 
+// Description: Selects the <editor->selection_size> bytes at <match> and moves
+//              the window so that all of them are onscreen. The window moves
+//              the least when it follows the direction from <prev_match>.
+static void select_match(
+  s_editor* const editor, const uint24_t match, const uint24_t prev_match
+);
+
+
+// Description: Finds every signature that tool_SetSignatures() was given at
+//              once and steps through the hits. If there are <names>, each
+//              hit is labelled with its signature's name.
+// Pre:         <names> may be NULL.
+static void signature_viewer(
+  s_editor* const editor, const char* const names[]
+);
+
+
+// Description: Writes each encoding of the decimal number in <digits> as a
+//              signature, for tool_SetSignatures(), and its name to <names>.
+//              The number is encoded as 16-, 24-, and 32-bit integers, as
+//              many as can hold it, little- and big-endian, and as a TI real.
+// Post:        The size of the signatures returned, or zero if the number does
+//              not fit in 32 bits.
+static uint8_t value_signatures(
+  const char* const digits,
+  uint8_t signatures[MAX_VALUE_SIGNATURES_SIZE],
+  const char* names[MAX_NUM_VALUE_SIGNATURES]
+);
+
+
+// Description: Asks for a decimal number and finds all of its encodings at
+//              once.
+static void value_prompt(s_editor* const editor);
+
+
 static bool save_changes_prompt(s_editor* const editor);
 
 
@@ -102,10 +291,34 @@ CCDBG_BEGINBLOCK("editor_OpenVarEditor");
   s_calc_var var;
   uint24_t var_data_size;
   bool retval = true;
+  bool buffered;
   uint8_t* var_data;
+  uint8_t tab;
 
   var.vatptr = vatptr;
   hevat_GetVarInfoByVAT(&var);
+
+  // A variable that is already open is switched to instead of being opened a
+  // second time.
+  tab = find_tab(editor, var.name, var.name_length, true, var.type);
+
+  if (tab < tool_NumTabs())
+  {
+    switch_tab(editor, tab);
+    run_tabs(editor);
+
+CCDBG_ENDBLOCK();
+    return true;
+  }
+
+  if (!open_tab(editor))
+  {
+    gui_ErrorWindow("Cannot open another$tab.");
+
+CCDBG_ENDBLOCK();
+    return false;
+  }
+
   memset(editor->name, '\0', G_EDITOR_NAME_MAX_LEN);
   strncpy(editor->name, var.name, var.name_length);
   editor->name_length = var.name_length;
@@ -113,7 +326,7 @@ CCDBG_BEGINBLOCK("editor_OpenVarEditor");
   editor->tios_var_type = var.type;
   editor->undo_buffer_active = true;
   editor->num_changes = 0;
-  editor->base_address = tool_EditBufferPtr(&editor->buffer_size);
+  editor->undo_evicted = false;
 
   if (var.named)
   {
@@ -121,12 +334,6 @@ CCDBG_BEGINBLOCK("editor_OpenVarEditor");
     var_data = var.data + 2;
     var_data_size = var.size - 2;
   }
-  else if (var.archived)
-  {
-    editor->access_type = 'r';
-    var_data = var.data;
-    var_data_size = var.size;
-  }
   else
   {
     editor->access_type = 'w';
@@ -138,19 +345,22 @@ CCDBG_BEGINBLOCK("editor_OpenVarEditor");
   editor->selection_active = false;
   editor->high_nibble = true;
 
-  if (tool_BufferVarData(editor, var_data, var_data_size, offset))
-  {
-    tool_InitUndoStack();
-    run_editor(editor);
-  }
+  // Archived variables are viewed straight from flash, and variables in RAM
+  // are edited where they are, so opening a variable copies nothing. The data
+  // is only copied into the edit buffer once it is resized. A variable edited
+  // in place may get its undo records back from a leftover journal, so the
+  // undo stack is emptied first.
+  tool_InitUndoStack();
+  buffered = tool_PageVarData(
+    editor, var_data, var_data_size, offset, !var.archived
+  );
+
+  if (buffered)
+    run_tabs(editor);
   else
   {
-    gui_ErrorWindow(
-      "You do not have enough$free RAM to edit this$variable. Archive or" \
-      "delete$variables to free more RAM.$Make sure the EDB is$greater than" \
-      "the variable's$size."
-    );
-
+    close_tab(editor);
+    gui_ErrorWindow("Cannot open edit$buffer.");
     retval = false;
   }
 
@@ -171,6 +381,25 @@ void editor_OpenMemEditor(
 CCDBG_BEGINBLOCK("editor_OpenMemEditor");
 CCDBG_DUMP_UINT(strlen(name));
 
+  uint8_t tab = find_tab(editor, name, strlen(name), false, 0);
+
+  if (tab < tool_NumTabs())
+  {
+    switch_tab(editor, tab);
+    run_tabs(editor);
+
+CCDBG_ENDBLOCK();
+    return;
+  }
+
+  if (!open_tab(editor))
+  {
+    gui_ErrorWindow("Cannot open another$tab.");
+
+CCDBG_ENDBLOCK();
+    return;
+  }
+
   memset(editor->name, '\0', G_EDITOR_NAME_MAX_LEN);
   strncpy(editor->name, name, strlen(name));
   editor->name_length = strlen(name);
@@ -178,6 +407,7 @@ CCDBG_DUMP_UINT(strlen(name));
   editor->tios_var_type = 0;
   editor->undo_buffer_active = true;
   editor->num_changes = 0;
+  editor->undo_evicted = false;
   editor->base_address = base_address;
   editor->data_size = size;
   editor->buffer_size = size;
@@ -189,12 +419,15 @@ CCDBG_DUMP_UINT(strlen(name));
 
   editor->near_size = offset + 1;
   editor->far_size = size - offset - 1;
+  editor->gap_offset = size;
+  editor->paged = false;
+  editor->in_place = false;
   editor->selection_size = 1;
   editor->selection_active = false;
   editor->high_nibble = true;
 
   tool_InitUndoStack();
-  run_editor(editor);
+  run_tabs(editor);
 
 CCDBG_ENDBLOCK();
 
@@ -202,146 +435,563 @@ CCDBG_ENDBLOCK();
 }
 
 
-// =============================================================================
-// STATIC FUNCTION DEFINITIONS
-// =============================================================================
-
-
-static void run_editor(s_editor* const editor)
+void editor_ResumeTabs(s_editor* const editor)
 {
-CCDBG_BEGINBLOCK("run_editor");
+  if (tool_NumTabs())
+    run_tabs(editor);
 
-  const uint8_t KEYPRESS_DELAY_THRESHOLD = 7;
-  bool quit = false;
-  bool redraw_location_col = true;  // Draw the column for initialization.
-  bool blit = true;
-  bool accel_cursor = false;
-  uint8_t writing_value = 0;
+  return;
+}
 
-  if (editor->selection_size > 1)
-    editor->selection_active = true;
 
-  tool_UpdateWindowOffset(editor);
+void editor_RecoverJournals(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("editor_RecoverJournals");
 
-  while (!quit)
+  s_calc_var var;
+  char name[20];
+  void* vatptr;
+  bool decided;
+
+  for (uint8_t journal = 0; journal < G_MAX_NUM_TABS; journal++)
   {
-    gfx_SetColor(g_color.bar);
-    gfx_VertLine_NoClip(60, 20, 200);
-    gfx_VertLine_NoClip(61, 20, 200);
-    gfx_VertLine_NoClip(230, 20, 200);
-    gfx_VertLine_NoClip(231, 20, 200);
+    if (!tool_GetJournalVar(journal, &vatptr))
+      continue;
 
-    // gui_DrawTitleBar() must be called every iteration because the battery
-    // status updates on a timer.
-    gui_DrawTitleBar(editor);
-    gui_DrawToolBar(editor);
-    gui_PrintData(editor);
+    var.vatptr = vatptr;
+    hevat_GetVarInfoByVAT(&var);
+    hevat_VarNameToASCII(name, (uint8_t*)var.name, var.named);
+    gui_DrawRecoveryPrompt(name);
+    gfx_BlitBuffer();
+    decided = false;
 
-    if (redraw_location_col)
+    while (!decided)
     {
-      gui_DrawLocationColumn(editor);
-      redraw_location_col = false;
-      blit = true;
-    }
+      keypad_IdleKeypadBlock();
 
-    if (blit)
-    {
-      gfx_BlitBuffer();
-      blit = false;
+      // Keep the edits.
+      if (keypad_SinglePressExclusive(kb_KeyZoom))
+      {
+        tool_DeleteJournal(journal);
+        decided = true;
+      }
+
+      // Undo the edits.
+      if (keypad_SinglePressExclusive(kb_KeyTrace))
+      {
+        tool_RollBackJournal(journal);
+        decided = true;
+      }
+
+      // Keep editing. The variable's new tab takes over the journal.
+      if (keypad_SinglePressExclusive(kb_KeyGraph))
+      {
+        editor_OpenVarEditor(editor, vatptr, 0);
+        decided = true;
+      }
     }
-    else
-      gfx_SwapDraw();
+  }
 
-    // Slow down the cursor for small variables.
-    if (editor->data_size < G_NUM_BYTES_ONSCREEN / 2)
-      delay(30);
+CCDBG_ENDBLOCK();
+  return;
+}
 
-    keypad_IdleKeypadBlock();
 
-    if (
-      keypad_SinglePressExclusive(kb_KeyYequ)
-      && tool_IsAvailable(editor, &tool_FindPhrase)
-    )
-    {
-      find_prompt(editor);
-      redraw_location_col = true;
-    }
+bool editor_PhrasePrompt(
+  const s_editor* const editor,
+  uint8_t phrase[8],
+  uint8_t mask[8],
+  uint8_t* const length,
+  bool* const masked
+)
+{
+  const char** keymaps[] = {
+    G_HEX_PATTERN_KEYMAP, G_UPPERCASE_LETTERS_KEYMAP,
+    G_LOWERCASE_LETTERS_KEYMAP, G_DIGITS_KEYMAP
+  };
+  const char keymap_indicators[] = { 'x', 'A', 'a', '0' };
+  char buffer[17] = { '\0' };
+  uint8_t live_phrase[8];
+  uint8_t live_mask[8];
+  uint8_t live_length;
+  bool live_masked;
+  uint8_t keymap_idx = 0;
+  uint8_t buffer_size = 16;
 
-    if (
-      keypad_SinglePressExclusive(kb_KeyWindow)
-      && tool_IsAvailable(editor, &tool_InsertBytes)
-    )
-    {
-      insert_bytes_prompt(editor);
-      redraw_location_col = true;
-    }
+  g_live_find.length = 0;
 
-    if (keypad_SinglePressExclusive(kb_KeyZoom))
+  while (true)
+  {
+    kb_Scan();
+    gui_DrawInputPrompt("Find:", 152);
+    gui_DrawKeymapIndicator(keymap_indicators[keymap_idx], 182, 223);
+    gui_SetTextColor(g_color.background, g_color.list_text_normal);
+
+    // The typed text is shown while the data is searched for it, before
+    // gui_Input() waits for the next key.
+    gfx_SetTextXY(44, 226);
+    gui_PrintText(buffer);
+    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
+
+    if (editor && g_live_find.length)
     {
-      if (tool_IsAvailable(editor, &tool_Goto))
-      {
-        goto_prompt(editor);
-      }
-      else if (tool_IsAvailable(editor, &tool_CopyBytes))
+      while (true)
       {
-        tool_CopyBytes(editor);
+        gui_DrawFindProgress(
+          editor,
+          g_live_find.num_matches,
+          g_live_find.matches[0],
+          !g_live_find.finished
+        );
+
+        if (g_live_find.finished)
+          break;
+
+        kb_Scan();
+
+        if (kb_AnyKey())
+          break;
+
+        live_find_step(editor);
       }
+
+      gui_SetTextColor(g_color.background, g_color.list_text_normal);
     }
 
-    if (keypad_SinglePressExclusive(kb_KeyTrace))
+    gui_Input(buffer, buffer_size, 42, 224, 149, keymaps[keymap_idx]);
+
+    if (keypad_SinglePressExclusive(kb_KeyClear) && !strlen(buffer))
+      return false;
+
+    if (keypad_SinglePressExclusive(kb_KeyAlpha))
     {
-      if (tool_IsAvailable(editor, &tool_UndoLastAction))
-      {
-        tool_UndoLastAction(editor);
-      }
-      else if (tool_IsAvailable(editor, &tool_CutBytes))
-      {
-        tool_AddUndo_DeleteOrCutBytes(editor);
-        tool_CutBytes(editor);
-      }
+      if (!strlen(buffer))
+        keymap_idx = (keymap_idx + 1) % 4;
+      else if (keymaps[keymap_idx] != G_HEX_PATTERN_KEYMAP)
+        keymap_idx = ((keymap_idx + 1) % 4) + (keymap_idx == 3 ? 1 : 0);
 
-      redraw_location_col = true;
+      if (keymaps[keymap_idx] == G_HEX_PATTERN_KEYMAP)
+        buffer_size = 16;
+      else
+        buffer_size = 8;
     }
 
-    if (keypad_SinglePressExclusive(kb_KeyGraph))
+    if (
+      keypad_SinglePressExclusive(kb_Key2nd)
+      || keypad_SinglePressExclusive(kb_KeyEnter)
+    )
     {
-      if (tool_IsAvailable(editor, &tool_SwitchWritingMode))
+      *length = strlen(buffer);
+
+      if (keymaps[keymap_idx] == G_HEX_PATTERN_KEYMAP)
       {
-        tool_SwitchWritingMode(editor);
+        if (*length > 3 && *length % 2 == 0)
+        {
+          *masked = ascii_to_nibble(buffer, phrase, mask);
+          *length /= 2;
+          return true;
+        }
+
+        gui_DrawFindPromptMessage("4 or more chars");
       }
-      else if (tool_IsAvailable(editor, &tool_PasteBytes))
+      else
       {
-        tool_AddUndo_PasteBytes(editor);
-        tool_PasteBytes(editor);
-        redraw_location_col = true;
+        if (*length > 1)
+        {
+          memcpy(phrase, buffer, *length);
+          *masked = false;
+          return true;
+        }
+
+        gui_DrawFindPromptMessage("2 or more chars");
       }
     }
 
     if (
-      (
-        keypad_SinglePressExclusive(kb_Key2nd)
-        || keypad_SinglePressExclusive(kb_KeyEnter)
+      editor
+      && live_find_phrase(
+        buffer,
+        keymaps[keymap_idx] == G_HEX_PATTERN_KEYMAP,
+        live_phrase,
+        live_mask,
+        &live_length,
+        &live_masked
       )
-      && editor->near_size
     )
     {
-      toggle_cursor_selection(editor, !editor->selection_active);
+      live_find_update(
+        editor, live_phrase, live_mask, live_length, live_masked
+      );
     }
+    else
+      g_live_find.length = 0;
+  }
+}
 
-    if (
-      keypad_SinglePressExclusive(kb_KeyMode)
-      && !editor->is_tios_var
-    )
-    {
-      if (editor->location_col_mode == 'a')
-        editor->location_col_mode = 'o';
-      else
-        editor->location_col_mode = 'a';
 
-      redraw_location_col = true;
-    }
+bool editor_OpenVarEditorAtMatch(
+  s_editor* const editor,
+  void* const vatptr,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t phrase_length,
+  const uint24_t match
+)
+{
+  bool retval;
 
-    if (
+  g_open_phrase = phrase;
+  g_open_mask = mask;
+  g_open_phrase_length = phrase_length;
+
+  retval = editor_OpenVarEditor(editor, vatptr, match);
+  g_open_phrase = NULL;
+  return retval;
+}
+
+
+// =============================================================================
+// STATIC FUNCTION DEFINITIONS
+// =============================================================================
+
+
+static bool open_tab(s_editor* const editor)
+{
+  if (tool_NumTabs())
+    g_tab_editors[tool_ActiveTab()] = *editor;
+
+  return tool_OpenTab(editor);
+}
+
+
+static void close_tab(s_editor* const editor)
+{
+  uint8_t closed_tab = tool_ActiveTab();
+
+  tool_CloseTab(editor);
+
+  memmove(
+    &g_tab_editors[closed_tab],
+    &g_tab_editors[closed_tab + 1],
+    (tool_NumTabs() - closed_tab) * sizeof(s_editor)
+  );
+
+  if (tool_NumTabs())
+  {
+    *editor = g_tab_editors[tool_ActiveTab()];
+    tool_SwitchTab(editor, tool_ActiveTab());
+  }
+
+  return;
+}
+
+
+static void switch_tab(s_editor* const editor, const uint8_t tab)
+{
+  g_tab_editors[tool_ActiveTab()] = *editor;
+  *editor = g_tab_editors[tab];
+  tool_SwitchTab(editor, tab);
+  return;
+}
+
+
+static uint8_t find_tab(
+  const s_editor* const editor,
+  const char* const name,
+  const uint8_t name_length,
+  const bool is_tios_var,
+  const uint8_t tios_var_type
+)
+{
+  const s_editor* tab_editor;
+  uint8_t tab;
+
+  for (tab = 0; tab < tool_NumTabs(); tab++)
+  {
+    tab_editor = (tab == tool_ActiveTab() ? editor : &g_tab_editors[tab]);
+
+    if (
+      tab_editor->is_tios_var == is_tios_var
+      && tab_editor->tios_var_type == tios_var_type
+      && tab_editor->name_length == name_length
+      && !memcmp(tab_editor->name, name, name_length)
+    )
+    {
+      break;
+    }
+  }
+
+  return tab;
+}
+
+
+static void run_tabs(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("run_tabs");
+
+  while (tool_NumTabs())
+  {
+    switch (run_editor(editor))
+    {
+      case EDITOR_CLOSE_TAB:
+        close_tab(editor);
+        break;
+
+      case EDITOR_SWITCH_TAB:
+        switch_tab(editor, (tool_ActiveTab() + 1) % tool_NumTabs());
+        break;
+
+      case EDITOR_OPEN_TAB:
+CCDBG_ENDBLOCK();
+        return;
+
+      default:
+        assert(false);
+        break;
+    }
+  }
+
+CCDBG_ENDBLOCK();
+  return;
+}
+
+
+static uint8_t run_editor(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("run_editor");
+
+  const uint8_t KEYPRESS_DELAY_THRESHOLD = 7;
+  uint8_t exit_code = EDITOR_CLOSE_TAB;
+  bool quit = false;
+  bool redraw_location_col = true;  // Draw the column for initialization.
+  bool scrolled = false;
+  bool save_checked = (editor->num_changes != 0);
+  bool blit = true;
+  bool accel_cursor = false;
+  uint8_t writing_value = 0;
+  uint24_t match;
+  uint24_t shortfall;
+
+  if (editor->selection_size > 1)
+    editor->selection_active = true;
+
+  tool_UpdateWindowOffset(editor);
+
+  while (!quit)
+  {
+    gfx_SetColor(g_color.bar);
+    gfx_VertLine_NoClip(60, 20, 200);
+    gfx_VertLine_NoClip(61, 20, 200);
+    gfx_VertLine_NoClip(230, 20, 200);
+    gfx_VertLine_NoClip(231, 20, 200);
+
+    // gui_DrawTitleBar() must be called every iteration because the battery
+    // status updates on a timer.
+    gui_DrawTitleBar(editor);
+    gui_DrawToolBar(editor);
+
+    // Prompts and viewers draw over the data, so all of it is drawn again
+    // after them. A scroll only draws the rows that came into view.
+    if (redraw_location_col)
+      gui_InvalidateData();
+
+    gui_PrintData(editor);
+
+    if (redraw_location_col || scrolled)
+    {
+      gui_DrawLocationColumn(editor);
+      redraw_location_col = false;
+      scrolled = false;
+      blit = true;
+    }
+
+    if (blit)
+    {
+      gui_BlitBuffer();
+      blit = false;
+    }
+    else
+      gui_SwapDraw();
+
+    // Slow down the cursor for small variables.
+    if (editor->data_size < G_NUM_BYTES_ONSCREEN / 2)
+      delay(30);
+
+    // A variable opened from a search of every variable goes straight to the
+    // find viewer once the editor has been drawn.
+    if (g_open_phrase)
+    {
+      if (
+        tool_IsAvailable(editor, &tool_FindNextPhrase)
+        && (
+          tool_FindNextPhrase(
+            editor,
+            g_open_phrase,
+            g_open_mask,
+            g_open_phrase_length,
+            editor->near_size ? editor->near_size - 1 : 0,
+            true,
+            &match
+          )
+          || tool_FindNextPhrase(
+            editor,
+            g_open_phrase,
+            g_open_mask,
+            g_open_phrase_length,
+            0,
+            true,
+            &match
+          )
+        )
+      )
+      {
+        find_viewer(
+          editor, g_open_phrase, g_open_mask, g_open_phrase_length, match
+        );
+      }
+
+      g_open_phrase = NULL;
+      redraw_location_col = true;
+      continue;
+    }
+
+    keypad_IdleKeypadBlock();
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyYequ)
+      && tool_IsAvailable(editor, &tool_FindNextPhrase)
+    )
+    {
+      find_prompt(editor);
+      redraw_location_col = true;
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyAdd)
+      && tool_IsAvailable(editor, &tool_FindSignatures)
+    )
+    {
+      // The appvar is read every time, so it can be edited in another tab.
+      if (tool_LoadSignatures())
+        signature_viewer(editor, NULL);
+      else
+        gui_ErrorWindow("No signatures in$HXAESIGS appvar.");
+
+      redraw_location_col = true;
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeySub)
+      && tool_IsAvailable(editor, &tool_FindSignatures)
+    )
+    {
+      value_prompt(editor);
+      redraw_location_col = true;
+    }
+
+    // The ports with side effects are only read when a snapshot is taken.
+    if (
+      keypad_SinglePressExclusive(kb_KeyDecPnt)
+      && tool_IsAvailable(editor, &tool_TakePortsSnapshot)
+    )
+    {
+      tool_TakePortsSnapshot(editor);
+      redraw_location_col = true;
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyChs)
+      && tool_PortsSnapshotActive(editor)
+    )
+    {
+      tool_EndPortsSnapshot();
+      redraw_location_col = true;
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyWindow)
+      && tool_IsAvailable(editor, &tool_InsertBytes)
+    )
+    {
+      insert_bytes_prompt(editor);
+      redraw_location_col = true;
+    }
+
+    if (keypad_SinglePressExclusive(kb_KeyZoom))
+    {
+      if (tool_IsAvailable(editor, &tool_Goto))
+      {
+        goto_prompt(editor);
+      }
+      else if (tool_IsAvailable(editor, &tool_CopyBytes))
+      {
+        tool_CopyBytes(editor);
+      }
+    }
+
+    if (keypad_SinglePressExclusive(kb_KeyTrace))
+    {
+      if (tool_IsAvailable(editor, &tool_UndoLastAction))
+      {
+        tool_UndoLastAction(editor);
+      }
+      else if (tool_IsAvailable(editor, &tool_CutBytes))
+      {
+        tool_AddUndo_DeleteOrCutBytes(editor);
+        tool_CutBytes(editor);
+      }
+
+      redraw_location_col = true;
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyGraphVar)
+      && tool_IsAvailable(editor, &tool_RedoLastAction)
+    )
+    {
+      tool_RedoLastAction(editor);
+      redraw_location_col = true;
+    }
+
+    if (keypad_SinglePressExclusive(kb_KeyGraph))
+    {
+      if (tool_IsAvailable(editor, &tool_SwitchWritingMode))
+      {
+        tool_SwitchWritingMode(editor);
+      }
+      else if (tool_IsAvailable(editor, &tool_PasteBytes))
+      {
+        tool_AddUndo_PasteBytes(editor);
+        tool_PasteBytes(editor);
+        redraw_location_col = true;
+      }
+    }
+
+    if (
+      (
+        keypad_SinglePressExclusive(kb_Key2nd)
+        || keypad_SinglePressExclusive(kb_KeyEnter)
+      )
+      && editor->near_size
+    )
+    {
+      toggle_cursor_selection(editor, !editor->selection_active);
+    }
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyMode)
+      && !editor->is_tios_var
+    )
+    {
+      if (editor->location_col_mode == 'a')
+        editor->location_col_mode = 'o';
+      else
+        editor->location_col_mode = 'a';
+
+      redraw_location_col = true;
+    }
+
+    if (
       kb_IsDown(kb_KeyDel)
       && tool_IsAvailable(editor, &tool_DeleteBytes)
     )
@@ -355,12 +1005,31 @@ CCDBG_BEGINBLOCK("run_editor");
     {
       if (editor->selection_active)
         toggle_cursor_selection(editor, false);
-      else if (editor->num_changes)
+      else if (editor->num_changes || editor->undo_evicted)
+      {
         quit = save_changes_prompt(editor);
+        redraw_location_col = true;
+      }
       else
         quit = true;
     }
 
+    if (keypad_SinglePressExclusive(kb_KeyVars) && tool_NumTabs() > 1)
+    {
+      exit_code = EDITOR_SWITCH_TAB;
+      quit = true;
+    }
+
+    // The tab stays open while another variable is chosen from the main menu.
+    if (
+      keypad_SinglePressExclusive(kb_KeyStat)
+      && tool_NumTabs() < G_MAX_NUM_TABS
+    )
+    {
+      exit_code = EDITOR_OPEN_TAB;
+      quit = true;
+    }
+
     if (kb_IsDown(kb_KeyAlpha))
       accel_cursor = true;
     else
@@ -399,193 +1068,771 @@ CCDBG_BEGINBLOCK("run_editor");
         if (!editor->high_nibble)
           tool_MoveCursor(editor, 1, 1);
         else
-          editor->high_nibble = false;
+          editor->high_nibble = false;
+      }
+    }
+    else
+    {
+      if (
+        keypad_ExclusiveASCII(&writing_value, editor->writing_mode)
+        && tool_IsAvailable(editor, &tool_WriteByte)
+      )
+      {
+        tool_AddUndo_WriteByte(editor);
+        tool_WriteByte(editor, writing_value);
+        tool_MoveCursor(editor, 1, 1);
+      }
+    }
+
+    // Saving an archived paged variable needs enough free RAM to unarchive
+    // it, so the user is told on the first change if there is not enough.
+    if (!save_checked && editor->num_changes)
+    {
+      save_checked = true;
+      shortfall = tool_SaveRAMShortfall(editor);
+
+      if (shortfall)
+      {
+        gui_SaveRAMWindow("Warning", shortfall);
+        redraw_location_col = true;
+      }
+    }
+
+    scrolled = tool_UpdateWindowOffset(editor);
+  }
+
+  tool_SyncJournal(editor);
+
+CCDBG_DUMP_UINT(exit_code);
+CCDBG_ENDBLOCK();
+  return exit_code;
+}
+
+
+static void goto_prompt(s_editor* const editor)
+{
+  const char** keymap = NULL;
+  char keymap_indicator = 'x';
+  char buffer[8] = { '\0' };
+  uint8_t buffer_size;
+  uint24_t offset;
+  uint24_t address;
+
+  if (editor->location_col_mode == 'o')
+  {
+    keymap = G_DIGITS_KEYMAP;
+    keymap_indicator = '0';
+    buffer_size = 7;
+  }
+  else
+  {
+    keymap = G_HEX_ASCII_KEYMAP;
+    buffer_size = 6;
+  }
+
+  while (true)
+  {
+    kb_Scan();
+    gui_DrawInputPrompt("Goto:", 102);
+    gui_DrawKeymapIndicator(keymap_indicator, 135, 223);
+    gui_SetTextColor(g_color.background, g_color.list_text_normal);
+    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
+    gui_Input(buffer, buffer_size, 44, 224, 99, keymap);
+
+    if (keypad_SinglePressExclusive(kb_KeyClear))
+      return;
+
+    if (
+      keypad_SinglePressExclusive(kb_Key2nd)
+      || keypad_SinglePressExclusive(kb_KeyEnter)
+    )
+    {
+      break;
+    }
+  }
+
+CCDBG_PUTS(buffer);
+
+  if (editor->location_col_mode == 'o')
+    offset = atoi(buffer);
+  else
+  {
+    address = cutil_HexToUint(buffer);
+
+    if (address < (uint24_t)editor->base_address)
+      offset = 0;
+    else
+      offset = address - (uint24_t)editor->base_address;
+  }
+
+CCDBG_DUMP_UINT(offset);
+
+  tool_Goto(editor, offset);
+  return;
+}
+
+
+static void insert_bytes_prompt(s_editor* const editor)
+{
+  char buffer[7] = { '\0' };
+  uint24_t num_bytes;
+
+  while (true)
+  {
+    kb_Scan();
+    gui_DrawInputPrompt("Insert:", 102);
+    gui_DrawKeymapIndicator('0', 151, 223);
+    gui_SetTextColor(g_color.background, g_color.list_text_normal);
+    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
+    gui_Input(buffer, 6, 60, 224, 99, G_DIGITS_KEYMAP);
+
+    if (keypad_SinglePressExclusive(kb_KeyClear))
+      return;
+
+    if (
+      keypad_SinglePressExclusive(kb_Key2nd)
+      || keypad_SinglePressExclusive(kb_KeyEnter)
+    )
+    {
+      break;
+    }
+  }
+
+  num_bytes = atoi(buffer);
+
+  if (!num_bytes)
+    return;
+
+  // The undo record is only pushed for bytes that will all be inserted.
+  if (!tool_CanInsertBytes(editor, num_bytes))
+  {
+    gui_ErrorWindow("Not enough memory$to insert bytes.");
+    return;
+  }
+
+  tool_AddUndo_InsertBytes(editor, num_bytes);
+  tool_InsertBytes(editor, num_bytes);
+  return;
+}
+
+
+static bool ascii_to_nibble(
+  const char* ascii_buffer, uint8_t* nibble_buffer, uint8_t* mask_buffer
+)
+{
+  assert(strlen(ascii_buffer) % 2 == 0);
+
+  uint8_t idx = 0;
+  uint8_t length = strlen(ascii_buffer);
+  uint8_t shift;
+  bool wildcards = false;
+
+  while (idx < length)
+  {
+    shift = (idx % 2 ? 0 : 4);
+
+    if (shift)
+    {
+      nibble_buffer[idx / 2] = 0;
+      mask_buffer[idx / 2] = 0;
+    }
+
+    if (ascii_buffer[idx] == '?')
+      wildcards = true;
+    else
+    {
+      nibble_buffer[idx / 2] |= (
+        ascii_buffer[idx] <= '9'
+        ? ascii_buffer[idx] - '0'
+        : ascii_buffer[idx] - 'a' + 10
+      ) << shift;
+      mask_buffer[idx / 2] |= 0x0f << shift;
+    }
+
+    idx++;
+  }
+
+  return wildcards;
+}
+
+
+static bool live_find_phrase(
+  const char* const buffer,
+  const bool hex,
+  uint8_t phrase[8],
+  uint8_t mask[8],
+  uint8_t* const length,
+  bool* const masked
+)
+{
+  char nibbles[17] = { '\0' };
+  uint8_t buffer_length = strlen(buffer);
+
+  if (hex)
+  {
+    if (buffer_length < 3)
+      return false;
+
+    strcpy(nibbles, buffer);
+
+    if (buffer_length % 2)
+      nibbles[buffer_length++] = '?';
+
+    *masked = ascii_to_nibble(nibbles, phrase, mask);
+    *length = buffer_length / 2;
+  }
+  else
+  {
+    if (buffer_length < 2)
+      return false;
+
+    memcpy(phrase, buffer, buffer_length);
+    memset(mask, 0xff, buffer_length);
+    *masked = false;
+    *length = buffer_length;
+  }
+
+  return true;
+}
+
+
+static void live_find_update(
+  const s_editor* const editor,
+  const uint8_t phrase[8],
+  const uint8_t mask[8],
+  const uint8_t length,
+  const bool masked
+)
+{
+  s_live_find* const live = &g_live_find;
+  bool narrows = (
+    live->length
+    && length >= live->length
+    && live->num_matches <= MAX_NUM_LIVE_MATCHES
+  );
+  uint24_t num_kept = 0;
+
+  if (
+    live->length == length
+    && !memcmp(live->phrase, phrase, length)
+    && !memcmp(live->mask, mask, length)
+  )
+  {
+    return;
+  }
+
+  // A phrase narrows the last one if it has every bit that the last one has.
+  for (uint8_t idx = 0; narrows && idx < live->length; idx++)
+  {
+    narrows = (
+      (mask[idx] & live->mask[idx]) == live->mask[idx]
+      && (phrase[idx] & live->mask[idx]) == live->phrase[idx]
+    );
+  }
+
+  if (narrows)
+  {
+    for (uint24_t idx = 0; idx < live->num_matches; idx++)
+    {
+      if (live_find_match(editor, live->matches[idx], phrase, mask, length))
+        live->matches[num_kept++] = live->matches[idx];
+    }
+
+    live->num_matches = num_kept;
+  }
+  else
+  {
+    live->num_matches = 0;
+    live->start = editor->near_size ? editor->near_size - 1 : 0;
+    live->offset = live->start;
+    live->wrapped = false;
+    live->finished = false;
+  }
+
+  memcpy(live->phrase, phrase, length);
+  memcpy(live->mask, mask, length);
+  live->length = length;
+  live->masked = masked;
+  return;
+}
+
+
+static void live_find_step(const s_editor* const editor)
+{
+  s_live_find* const live = &g_live_find;
+  uint24_t end;
+  uint24_t last;
+  uint24_t match;
+
+  if (editor->data_size < live->length)
+  {
+    live->finished = true;
+    return;
+  }
+
+  // The first pass goes from the cursor to the end of the data, and the second
+  // from the start of the data to the cursor.
+  end = editor->data_size - live->length;
+
+  if (live->wrapped)
+    end = min(end, live->start - 1);
+
+  if (live->offset <= end)
+  {
+    last = min(end, live->offset + LIVE_FIND_SLICE_SIZE - 1);
+
+    while (
+      live->offset <= last
+      && tool_FindPhraseInRange(
+        editor,
+        live->phrase,
+        live->masked ? live->mask : NULL,
+        live->length,
+        live->offset,
+        last,
+        &match
+      )
+    )
+    {
+      if (live->num_matches < MAX_NUM_LIVE_MATCHES)
+        live->matches[live->num_matches] = match;
+
+      live->num_matches++;
+      live->offset = match + 1;
+    }
+
+    live->offset = last + 1;
+  }
+
+  if (live->offset > end)
+  {
+    if (!live->wrapped && live->start)
+    {
+      live->wrapped = true;
+      live->offset = 0;
+    }
+    else
+      live->finished = true;
+  }
+
+  return;
+}
+
+
+static bool live_find_match(
+  const s_editor* const editor,
+  const uint24_t offset,
+  const uint8_t phrase[8],
+  const uint8_t mask[8],
+  const uint8_t length
+)
+{
+  uint8_t value;
+
+  if (offset + length > editor->data_size)
+    return false;
+
+  // A longer phrase can reach past the end of a range of ports that can be
+  // read, so each byte is checked before it is read.
+  for (uint8_t idx = 0; idx < length; idx++)
+  {
+    if (
+      !tool_ViewByte(editor, offset + idx, &value)
+      || (value & mask[idx]) != phrase[idx]
+    )
+      return false;
+  }
+
+  return true;
+}
+
+
+static bool replace_prompt(
+  s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t phrase_length,
+  const uint24_t match
+)
+{
+  const char** keymaps[] = {
+    G_HEX_ASCII_KEYMAP, G_UPPERCASE_LETTERS_KEYMAP,
+    G_LOWERCASE_LETTERS_KEYMAP, G_DIGITS_KEYMAP
+  };
+  const char keymap_indicators[] = { 'x', 'A', 'a', '0' };
+  const uint24_t FIELD_XPOS = gfx_GetStringWidth("Replace:") + 10;
+  const uint24_t FIELD_WIDTH = 140;
+  char buffer[17] = { '\0' };
+  char replacement[8] = { '\0' };
+  uint8_t mask[8];
+  uint24_t num_replaced;
+  uint8_t replacement_length;
+  uint8_t keymap_idx = 0;
+  uint8_t buffer_size = 16;
+  bool replace = false;
+  bool replace_all;
+
+  while (true)
+  {
+    kb_Scan();
+    gui_DrawInputPrompt("Replace:", FIELD_WIDTH);
+    gui_DrawKeymapIndicator(
+      keymap_indicators[keymap_idx], FIELD_XPOS + FIELD_WIDTH - 10, 223
+    );
+    gui_SetTextColor(g_color.background, g_color.list_text_normal);
+    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
+    gui_Input(
+      buffer,
+      buffer_size,
+      FIELD_XPOS + 2,
+      224,
+      FIELD_WIDTH - 3,
+      keymaps[keymap_idx]
+    );
+
+    if (keypad_SinglePressExclusive(kb_KeyClear) && !strlen(buffer))
+      return false;
+
+    if (keypad_SinglePressExclusive(kb_KeyAlpha))
+    {
+      if (!strlen(buffer))
+        keymap_idx = (keymap_idx + 1) % 4;
+      else if (keymaps[keymap_idx] != G_HEX_ASCII_KEYMAP)
+        keymap_idx = ((keymap_idx + 1) % 4) + (keymap_idx == 3 ? 1 : 0);
+
+      if (keymaps[keymap_idx] == G_HEX_ASCII_KEYMAP)
+        buffer_size = 16;
+      else
+        buffer_size = 8;
+    }
+
+    // [enter] replaces every match, and [2nd] replaces the matches from the
+    // current one to the end of the data.
+    replace_all = keypad_SinglePressExclusive(kb_KeyEnter);
+
+    if (replace_all || keypad_SinglePressExclusive(kb_Key2nd))
+    {
+      replacement_length = strlen(buffer);
+
+      if (keymaps[keymap_idx] == G_HEX_ASCII_KEYMAP)
+      {
+        if (replacement_length > 1 && replacement_length % 2 == 0)
+        {
+          ascii_to_nibble(buffer, (uint8_t*)replacement, mask);
+          replacement_length /= 2;
+          replace = true;
+        }
+        else
+          gui_DrawFindPromptMessage("2 or more chars");
+      }
+      else
+      {
+        if (replacement_length)
+        {
+          strncpy(replacement, buffer, buffer_size);
+          replace = true;
+        }
+        else
+          gui_DrawFindPromptMessage("1 or more chars");
       }
-    }
-    else
-    {
+
+      // Only variables that can be resized can have their matches replaced
+      // with a phrase of a different length.
       if (
-        keypad_ExclusiveASCII(&writing_value, editor->writing_mode)
-        && tool_IsAvailable(editor, &tool_WriteByte)
+        replace
+        && replacement_length != phrase_length
+        && editor->access_type != 'i'
       )
       {
-        tool_AddUndo_WriteByte(editor);
-        tool_WriteByte(editor, writing_value);
-        tool_MoveCursor(editor, 1, 1);
+        gui_DrawFindPromptMessage("Same length only");
+        replace = false;
       }
+
+      if (replace)
+        break;
     }
+  }
 
-    redraw_location_col |= tool_UpdateWindowOffset(editor);
+  gui_DrawFindPromptMessage("Replacing...");
+  editor->selection_active = false;
+  editor->selection_size = 1;
+  num_replaced = tool_ReplacePhrase(
+    editor,
+    phrase,
+    phrase_length,
+    (const uint8_t*)replacement,
+    replacement_length,
+    replace_all ? 0 : match,
+    editor->data_size - 1
+  );
+
+  if (!num_replaced)
+  {
+    gui_ErrorWindow("Not enough memory$to replace.");
+    return true;
   }
 
-CCDBG_ENDBLOCK();
-  return;
+  gui_DrawReplacedMessage(num_replaced);
+
+  while (true)
+  {
+    keypad_IdleKeypadBlock();
+
+    if (keypad_SinglePressExclusive(kb_KeyClear))
+      break;
+  }
+
+  return true;
 }
 
 
-static void goto_prompt(s_editor* const editor)
+static void find_viewer(
+  s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t phrase_length,
+  uint24_t match
+)
 {
-  const char** keymap = NULL;
-  char keymap_indicator = 'x';
-  char buffer[8] = { '\0' };
-  uint8_t buffer_size;
-  uint24_t offset;
-  uint24_t address;
+CCDBG_BEGINBLOCK("find_viewer");
 
-  if (editor->location_col_mode == 'o')
-  {
-    keymap = G_DIGITS_KEYMAP;
-    keymap_indicator = '0';
-    buffer_size = 7;
-  }
-  else
-  {
-    keymap = G_HEX_ASCII_KEYMAP;
-    buffer_size = 6;
-  }
+  const uint8_t KEYPRESS_DELAY_THRESHOLD = 8;
+  uint24_t prev_match = match;
+  uint24_t next_match;
+
+  // Each match of a phrase with wildcards can have different bytes, so only
+  // exact phrases are replaced.
+  const bool replaceable = (
+    !mask && tool_IsAvailable(editor, &tool_ReplacePhrase)
+  );
+
+  editor->selection_size = phrase_length;
 
   while (true)
   {
-    kb_Scan();
-    gui_DrawInputPrompt("Goto:", 102);
-    gui_DrawKeymapIndicator(keymap_indicator, 135, 223);
-    gui_SetTextColor(g_color.background, g_color.list_text_normal);
-    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
-    gui_Input(buffer, buffer_size, 44, 224, 99, keymap);
 
-    if (keypad_SinglePressExclusive(kb_KeyClear))
-      return;
+CCDBG_DUMP_UINT(match);
+
+    select_match(editor, match, prev_match);
+    gui_DrawLocationColumn(editor);
+    gui_PrintData(editor);
+    gui_DrawFindPhraseToolbar(editor, match, replaceable);
+    gui_BlitBuffer();
+
+    keypad_IdleKeypadBlock();
 
     if (
       keypad_SinglePressExclusive(kb_Key2nd)
-      || keypad_SinglePressExclusive(kb_KeyEnter)
+      || keypad_SinglePressExclusive(kb_KeyClear)
     )
     {
       break;
     }
-  }
 
-CCDBG_PUTS(buffer);
+    if (
+      replaceable
+      && keypad_SinglePressExclusive(kb_KeyGraph)
+      && replace_prompt(editor, phrase, phrase_length, match)
+    )
+    {
+      break;
+    }
 
-  if (editor->location_col_mode == 'o')
-    offset = atoi(buffer);
-  else
-  {
-    address = cutil_HexToUint(buffer);
+    prev_match = match;
+    next_match = match;
 
-    if (address < (uint24_t)editor->base_address)
-      offset = 0;
-    else
-      offset = address - (uint24_t)editor->base_address;
+    // Each match is found when it is asked for, and the search wraps around
+    // the ends of the data. RAM can change while it is viewed, so the current
+    // match may be the only one left.
+    if (keypad_KeyPressedOrHeld(kb_KeyUp, KEYPRESS_DELAY_THRESHOLD))
+    {
+      if (
+        !match
+        || !tool_FindNextPhrase(
+          editor, phrase, mask, phrase_length, match - 1, false, &next_match
+        )
+      )
+      {
+        tool_FindNextPhrase(
+          editor, phrase, mask, phrase_length, editor->data_size - 1, false,
+          &next_match
+        );
+      }
+    }
+    else if (keypad_KeyPressedOrHeld(kb_KeyDown, KEYPRESS_DELAY_THRESHOLD))
+    {
+      if (
+        !tool_FindNextPhrase(
+          editor, phrase, mask, phrase_length, match + 1, true, &next_match
+        )
+      )
+      {
+        tool_FindNextPhrase(
+          editor, phrase, mask, phrase_length, 0, true, &next_match
+        );
+      }
+    }
+
+    match = next_match;
   }
 
-CCDBG_DUMP_UINT(offset);
+  editor->selection_active = false;
+  editor->selection_size = 1;
+
+CCDBG_ENDBLOCK();
 
-  tool_Goto(editor, offset);
   return;
 }
 
 
-static void insert_bytes_prompt(s_editor* const editor)
+static void find_prompt(s_editor* const editor)
 {
-  char buffer[7] = { '\0' };
-
-  while (true)
+  uint8_t phrase[8];
+  uint8_t mask[8];
+  const uint8_t* phrase_mask = NULL;
+  uint24_t match;
+  uint8_t phrase_length;
+  bool masked;
+  bool found;
+
+  if (!editor_PhrasePrompt(editor, phrase, mask, &phrase_length, &masked))
+    return;
+
+  // The mask is only used if the phrase has wildcards, since an exact search
+  // is faster.
+  if (masked)
+    phrase_mask = mask;
+
+  // The phrase may have been searched for while it was typed. Otherwise, the
+  // search starts at the cursor and wraps around to the start of the data.
+  if (
+    g_live_find.finished
+    && g_live_find.length == phrase_length
+    && g_live_find.masked == masked
+    && !memcmp(g_live_find.phrase, phrase, phrase_length)
+    && (!masked || !memcmp(g_live_find.mask, mask, phrase_length))
+  )
   {
-    kb_Scan();
-    gui_DrawInputPrompt("Insert:", 102);
-    gui_DrawKeymapIndicator('0', 151, 223);
-    gui_SetTextColor(g_color.background, g_color.list_text_normal);
-    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
-    gui_Input(buffer, 6, 60, 224, 99, G_DIGITS_KEYMAP);
+    found = g_live_find.num_matches;
+    match = g_live_find.matches[0];
+  }
+  else
+  {
+    gui_DrawFindPromptMessage("Searching...");
+    found = (
+      tool_FindNextPhrase(
+        editor,
+        phrase,
+        phrase_mask,
+        phrase_length,
+        editor->near_size ? editor->near_size - 1 : 0,
+        true,
+        &match
+      )
+      || tool_FindNextPhrase(
+        editor, phrase, phrase_mask, phrase_length, 0, true, &match
+      )
+    );
+  }
 
-    if (keypad_SinglePressExclusive(kb_KeyClear))
-      return;
+  if (found)
+    find_viewer(editor, phrase, phrase_mask, phrase_length, match);
+  else
+  {
+    gui_DrawFindPromptMessage("0 matches");
 
-    if (
-      keypad_SinglePressExclusive(kb_Key2nd)
-      || keypad_SinglePressExclusive(kb_KeyEnter)
-    )
+    while (true)
     {
-      break;
+      keypad_IdleKeypadBlock();
+
+      if (keypad_SinglePressExclusive(kb_KeyClear))
+        break;
     }
   }
 
-  tool_AddUndo_InsertBytes(editor, atoi(buffer));
-  tool_InsertBytes(editor, atoi(buffer));
   return;
 }
 
 
-static void ascii_to_nibble(char* ascii_buffer, char* nibble_buffer)
+static void select_match(
+  s_editor* const editor, const uint24_t match, const uint24_t prev_match
+)
 {
-  assert(strlen(ascii_buffer) % 2 == 0);
+  // This section massages the window offset using selective goto actions to
+  // make the entire selected phrase appear onscreen.
+  // ==================
+  editor->selection_active = false;
+  tool_Goto(editor, match);
 
-  uint8_t idx = 0;
-  uint8_t length = strlen(ascii_buffer);
+  if (prev_match >= match)
+    tool_UpdateWindowOffset(editor);
 
-  while (idx < length)
-  {
-    nibble_buffer[idx / 2] = (
-      ascii_buffer[idx] <= '9'
-      ? ascii_buffer[idx] - '0'
-      : ascii_buffer[idx] - 'a' + 10
-    ) << 4;
-    idx++;
-    nibble_buffer[idx / 2] |= (
-      ascii_buffer[idx] <= '9'
-      ? ascii_buffer[idx] - '0'
-      : ascii_buffer[idx] - 'a' + 10
-    );
-    idx++;
-  }
+  tool_Goto(editor, match + editor->selection_size - 1);
 
+  if (prev_match <= match)
+    tool_UpdateWindowOffset(editor);
+
+  editor->selection_active = true;
+  // ==================
   return;
 }
 
 
-static void find_viewer(
-  s_editor* const editor,
-  const uint24_t matches[],
-  const uint8_t num_matches,
-  const uint8_t phrase_length
+static void signature_viewer(
+  s_editor* const editor, const char* const names[]
 )
 {
-CCDBG_BEGINBLOCK("find_viewer");
+CCDBG_BEGINBLOCK("signature_viewer");
 
   const uint8_t KEYPRESS_DELAY_THRESHOLD = 8;
-  uint8_t prev_idx = 0;
-  uint8_t idx = 0;
+  uint24_t num_hits;
+  uint24_t match;
+  uint24_t prev_match;
+  uint8_t num_kept_hits;
+  uint8_t hit = 0;
+  uint8_t signature;
+  uint8_t length;
 
-  editor->selection_size = phrase_length;
+  gui_DrawFindPromptMessage("Scanning...");
 
-  while (true)
+  if (!(num_hits = tool_FindSignatures(editor)))
   {
+    gui_DrawFindPromptMessage("0 hits");
 
-CCDBG_DUMP_UINT(idx);
-CCDBG_DUMP_UINT(matches[idx]);
+    while (true)
+    {
+      keypad_IdleKeypadBlock();
 
-    // This section massages the window offset using selective goto actions to
-    // make the entire selected phrase appear onscreen.
-    // ==================
-    editor->selection_active = false;
-    tool_Goto(editor, matches[idx]);
+      if (keypad_SinglePressExclusive(kb_KeyClear))
+        break;
+    }
 
-    if (prev_idx >= idx)
-      tool_UpdateWindowOffset(editor);
+    return;
+  }
 
-    tool_Goto(editor, matches[idx] + editor->selection_size - 1);
+  num_kept_hits = tool_NumSignatureHits();
+  prev_match = tool_SignatureHit(0, &signature, &length);
 
-    if (prev_idx <= idx)
-      tool_UpdateWindowOffset(editor);
+  while (true)
+  {
+    match = tool_SignatureHit(hit, &signature, &length);
 
-    editor->selection_active = true;
-    // ==================
+CCDBG_DUMP_UINT(match);
+CCDBG_DUMP_UINT(signature);
 
+    editor->selection_size = length;
+    select_match(editor, match, prev_match);
     gui_DrawLocationColumn(editor);
     gui_PrintData(editor);
-    gui_DrawFindPhraseToolbar(idx, num_matches);
-    gfx_BlitBuffer();
+    gui_DrawSignatureToolbar(
+      editor,
+      match,
+      names ? names[signature - 1] : NULL,
+      signature,
+      hit + 1,
+      num_kept_hits,
+      num_hits > num_kept_hits
+    );
+    gui_BlitBuffer();
 
     keypad_IdleKeypadBlock();
 
@@ -597,12 +1844,14 @@ CCDBG_DUMP_UINT(matches[idx]);
       break;
     }
 
-    prev_idx = idx;
+    prev_match = match;
 
+    // The hits were found before the viewer started, so they wrap around
+    // instead of being searched for again.
     if (keypad_KeyPressedOrHeld(kb_KeyUp, KEYPRESS_DELAY_THRESHOLD))
-      idx = (idx ? idx - 1 : num_matches - 1);
+      hit = (hit ? hit : num_kept_hits) - 1;
     else if (keypad_KeyPressedOrHeld(kb_KeyDown, KEYPRESS_DELAY_THRESHOLD))
-      idx = (idx + 1) % num_matches;
+      hit = (hit + 1 < num_kept_hits ? hit + 1 : 0);
   }
 
   editor->selection_active = false;
@@ -614,104 +1863,116 @@ CCDBG_ENDBLOCK();
 }
 
 
-static void find_prompt(s_editor* const editor)
+static uint8_t value_signatures(
+  const char* const digits,
+  uint8_t signatures[MAX_VALUE_SIGNATURES_SIZE],
+  const char* names[MAX_NUM_VALUE_SIGNATURES]
+)
 {
-  const char** keymaps[] = {
-    G_HEX_ASCII_KEYMAP, G_UPPERCASE_LETTERS_KEYMAP,
-    G_LOWERCASE_LETTERS_KEYMAP, G_DIGITS_KEYMAP
+  const char* INTEGER_NAMES[] = {
+    "16-bit LE", "16-bit BE", "24-bit LE", "24-bit BE", "32-bit LE",
+    "32-bit BE"
   };
-  const char keymap_indicators[] = { 'x', 'A', 'a', '0' };
-  char buffer[17] = { '\0' };
-  char phrase[8] = { '\0' };
-  uint24_t matches[255];
-  uint8_t num_matches = 0;
-  uint8_t phrase_length;
-  uint8_t keymap_idx = 0;
-  uint8_t buffer_size = 16;
-  bool find_phrase = false;
+  const char* first_digit = digits;
+  uint8_t* signature = signatures;
+  uint32_t value = 0;
+  uint8_t num_digits;
+  uint8_t width;
+  uint8_t idx;
+
+  for (idx = 0; digits[idx]; idx++)
+  {
+    if (value > (UINT32_MAX - (digits[idx] - '0')) / 10)
+      return 0;
 
-  while (true)
+    value = value * 10 + (digits[idx] - '0');
+  }
+
+  for (width = 2; width <= sizeof(uint32_t); width++)
   {
-    kb_Scan();
-    gui_DrawInputPrompt("Find:", 152);
-    gui_DrawKeymapIndicator(keymap_indicators[keymap_idx], 182, 223);
-    gui_SetTextColor(g_color.background, g_color.list_text_normal);
-    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
-    gui_Input(buffer, buffer_size, 42, 224, 149, keymaps[keymap_idx]);
+    if (width < sizeof(uint32_t) && value >> (8 * width))
+      continue;
 
-    if (keypad_SinglePressExclusive(kb_KeyClear) && !strlen(buffer))
-      break;
+    *names++ = INTEGER_NAMES[(width - 2) * 2];
+    *signature++ = width;
 
-    if (keypad_SinglePressExclusive(kb_KeyAlpha))
-    {
-      if (!strlen(buffer))
-        keymap_idx = (keymap_idx + 1) % 4;
-      else if (keymaps[keymap_idx] != G_HEX_ASCII_KEYMAP)
-        keymap_idx = ((keymap_idx + 1) % 4) + (keymap_idx == 3 ? 1 : 0);
+    for (idx = 0; idx < width; idx++)
+      *signature++ = (value >> (8 * idx)) & 0xff;
 
-      if (keymaps[keymap_idx] == G_HEX_ASCII_KEYMAP)
-        buffer_size = 16;
-      else
-        buffer_size = 8;
-    }
+    *names++ = INTEGER_NAMES[(width - 2) * 2 + 1];
+    *signature++ = width;
 
-    if (
-      keypad_SinglePressExclusive(kb_Key2nd)
-      || keypad_SinglePressExclusive(kb_KeyEnter)
-    )
-    {
-      phrase_length = strlen(buffer);
+    for (idx = width; idx; idx--)
+      *signature++ = (value >> (8 * (idx - 1))) & 0xff;
+  }
 
-      if (keymaps[keymap_idx] == G_HEX_ASCII_KEYMAP)
-      {
-        if (phrase_length > 3 && phrase_length % 2 == 0)
-        {
-          ascii_to_nibble(buffer, phrase);
-          phrase_length /= 2;
-          find_phrase = true;
-        }
-        else
-          gui_DrawFindPromptMessage("4 or more chars");
-      }
-      else
-      {
-        if (phrase_length > 1)
-        {
-          strncpy(phrase, buffer, buffer_size);
-          find_phrase = true;
-        }
-        else
-          gui_DrawFindPromptMessage("2 or more chars");
-      }
+  // A real is positive with an exponent of 0x80 plus the number of digits
+  // after the first. Its digits are stored two to a byte, padded with zeros.
+  while (*first_digit == '0' && *(first_digit + 1))
+    first_digit++;
 
-      if (find_phrase)
-      {
-        gui_DrawFindPromptMessage("Searching...");
+  num_digits = strlen(first_digit);
+  *names++ = "Real";
+  *signature++ = TI_REAL_SIZE;
+  *signature++ = 0x00;
+  *signature++ = 0x80 + (value ? num_digits - 1 : 0);
+  memset(signature, 0, TI_REAL_SIZE - 2);
 
-        tool_FindPhrase(
-          editor, (const uint8_t*)phrase, phrase_length, matches, &num_matches
-        );
+  for (idx = 0; idx < num_digits; idx++)
+  {
+    if (idx % 2)
+      signature[idx / 2] |= first_digit[idx] - '0';
+    else
+      signature[idx / 2] = (first_digit[idx] - '0') << 4;
+  }
 
-        if (num_matches)
-          find_viewer(editor, matches, num_matches, phrase_length);
-        else
-        {
-          gui_DrawFindPromptMessage("0 matches");
+  signature += TI_REAL_SIZE - 2;
+  return signature - signatures;
+}
 
-          while (true)
-          {
-            keypad_IdleKeypadBlock();
 
-            if (keypad_SinglePressExclusive(kb_KeyClear))
-              break;
-          }
-        }
+static void value_prompt(s_editor* const editor)
+{
+  const uint24_t FIELD_XPOS = gfx_GetStringWidth("Value:") + 10;
+  const uint24_t FIELD_WIDTH = 102;
+  const char* names[MAX_NUM_VALUE_SIGNATURES];
+  uint8_t signatures[MAX_VALUE_SIGNATURES_SIZE];
+  char buffer[11] = { '\0' };
+  uint8_t size;
+
+  while (true)
+  {
+    kb_Scan();
+    gui_DrawInputPrompt("Value:", FIELD_WIDTH);
+    gui_DrawKeymapIndicator('0', FIELD_XPOS + FIELD_WIDTH - 10, 223);
+    gui_SetTextColor(g_color.background, g_color.list_text_normal);
+    gfx_BlitRectangle(1, 0, LCD_HEIGHT - 20, LCD_WIDTH, 20);
+    gui_Input(
+      buffer, 10, FIELD_XPOS + 2, 224, FIELD_WIDTH - 3, G_DIGITS_KEYMAP
+    );
+
+    if (keypad_SinglePressExclusive(kb_KeyClear) && !strlen(buffer))
+      return;
 
+    if (
+      (
+        keypad_SinglePressExclusive(kb_Key2nd)
+        || keypad_SinglePressExclusive(kb_KeyEnter)
+      )
+      && strlen(buffer)
+    )
+    {
+      if ((size = value_signatures(buffer, signatures, names)))
         break;
-      }
+
+      gui_DrawFindPromptMessage("Too large");
     }
   }
 
+CCDBG_PUTS(buffer);
+
+  tool_SetSignatures(signatures, size);
+  signature_viewer(editor, names);
   return;
 }
 
@@ -723,6 +1984,7 @@ static bool save_changes_prompt(s_editor* const editor)
   bool retval = false;
   bool quit = false;
   int8_t save_var_retval;
+  uint24_t shortfall;
 
   gui_DrawSavePrompt();
   gfx_BlitRectangle(1, 0, 220, LCD_WIDTH, 20);
@@ -736,10 +1998,17 @@ static bool save_changes_prompt(s_editor* const editor)
 
     if (keypad_SinglePressExclusive(kb_KeyTrace))
     {
-      if (!editor->is_tios_var)
+      // Memory and in-place edits are made directly to the data, so they
+      // must be undone to be discarded.
+      if (!editor->is_tios_var || editor->in_place)
       {
         while (editor->num_changes)
+        {
+          // Undoing a paste selects the restored bytes.
+          editor->selection_active = false;
+          editor->selection_size = 1;
           tool_UndoLastAction(editor);
+        }
       }
 
       retval = true;
@@ -753,9 +2022,16 @@ static bool save_changes_prompt(s_editor* const editor)
       else
         save_var_retval = 1;
 
+      // The changes are kept, so that they can be saved again once the
+      // problem is fixed.
       if (save_var_retval == 0)
       {
-        gui_ErrorWindow("Unable to save changes.");
+        shortfall = tool_SaveRAMShortfall(editor);
+
+        if (shortfall)
+          gui_SaveRAMWindow("Error", shortfall);
+        else
+          gui_ErrorWindow("Unable to save changes.");
       }
       else if (save_var_retval == -1)
       {
@@ -765,7 +2041,7 @@ static bool save_changes_prompt(s_editor* const editor)
         tool_FatalErrorExit();
       }
 
-      retval = true;
+      retval = (save_var_retval != 0);
       quit = true;
     }
   }
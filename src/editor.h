@@ -47,6 +47,20 @@ bool editor_OpenVarEditor(
 );
 
 
+// Description: Opens a variable with its cursor at <match> and steps through
+//              the matches of <phrase> in the find viewer.
+// Pre:         <mask> may be NULL. If it is not, <phrase> must already be
+//              ANDed with it.
+bool editor_OpenVarEditorAtMatch(
+  s_editor* const editor,
+  void* const vatptr,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t phrase_length,
+  const uint24_t match
+);
+
+
 void editor_OpenMemEditor(
   s_editor* const editor,
   const char* const name,
@@ -56,4 +70,31 @@ void editor_OpenMemEditor(
 );
 
 
+// Description: Returns to the open tabs, if there are any, until every tab is
+//              closed or the user leaves to open another tab.
+void editor_ResumeTabs(s_editor* const editor);
+
+
+// Description: Asks what to do with each variable that was edited in place
+//              when HexaEdit last failed to exit normally: keep its edits,
+//              undo them, or open it to keep editing with its undo history.
+void editor_RecoverJournals(s_editor* const editor);
+
+
+// Description: Asks for a phrase to find, in hexadecimal with "?" wildcards
+//              or as text. If there is an <editor>, its data is searched as
+//              the phrase is typed, and the number of matches is shown.
+// Pre:         <editor> may be NULL.
+// Post:        True returned if a phrase was entered, or false if the user
+//              backed out. <masked> is set if the phrase has wildcards, in
+//              which case <mask> holds them.
+bool editor_PhrasePrompt(
+  const s_editor* const editor,
+  uint8_t phrase[8],
+  uint8_t mask[8],
+  uint8_t* const length,
+  bool* const masked
+);
+
+
 #endif
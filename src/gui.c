@@ -65,6 +65,45 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define LIST_ITEM_PXL_HEIGHT (G_FONT_HEIGHT + 3)
 
+// Where the first row of data cells is drawn.
+#define DATA_HEX_XPOS   (67)
+#define DATA_YPOS       (22)
+#define DATA_ASCII_XPOS (237)
+
+
+// How a data cell was drawn. A cell that has no byte is drawn empty.
+enum CELL_STYLE : uint8_t
+{
+  CELL_EMPTY = 0,
+  CELL_SHOWN = 1,
+  CELL_READABLE = 2,
+  CELL_SELECTED = 4,
+  CELL_CURSOR_HIGH = 8,
+  CELL_CURSOR_LOW = 16,
+  CELL_STALE = 255  // Never matches a drawn cell, so the cell is redrawn.
+};
+
+
+// What the data cells of one draw buffer show. <values> only matters for the
+// cells whose <styles> have CELL_READABLE.
+typedef struct
+{
+  bool valid;
+  uint24_t window_offset;
+  uint8_t values[G_NUM_BYTES_ONSCREEN];
+  uint8_t styles[G_NUM_BYTES_ONSCREEN];
+} s_data_frame;
+
+
+// File globals. Do NOT use these outside of this file.
+
+// One frame for each of the two buffers. <g_back_frame> is the frame of the
+// buffer being drawn to, and it changes sides when the buffers are swapped.
+static s_data_frame g_data_frames[2] = {
+  { .valid = false }, { .valid = false }
+};
+static uint8_t g_back_frame = 0;
+
 
 // =============================================================================
 // STATIC FUNCTION DECLARATIONS
@@ -85,6 +124,23 @@ static void draw_battery_status(void);
 static uint8_t get_num_bytes_onscreen(const s_editor* const editor);
 
 
+// Description: Moves the rows that are still onscreen after the window has
+//              scrolled to their new places, and marks the rows that came into
+//              view as stale.
+// Pre:         The window scrolled by fewer rows than are onscreen.
+static void shift_data_rows(
+  s_data_frame* const frame, const int24_t num_rows
+);
+
+
+// Description: Draws the data cell at <idx> over whatever was drawn there.
+static void draw_data_cell(
+  const uint8_t idx,
+  const uint8_t value,
+  const uint8_t style
+);
+
+
 static void print_text_wrap(const char* const text);
 
 
@@ -164,6 +220,7 @@ void gui_MessageWindowBlocking(const char* const title, const char* const msg)
   gfx_PrintStringXY("[clear]", XPOS + WIDTH - 52, YPOS + HEIGHT - 11);
 
   gfx_BlitRectangle(1, XPOS - 2, YPOS - 2, WIDTH + 4, HEIGHT + 4);
+  gui_InvalidateData();
 
   do {
     keypad_IdleKeypadBlock();
@@ -284,15 +341,16 @@ CCDBG_ENDBLOCK();
 }
 
 
-void gui_DrawMemoryAmounts(const s_editor* const editor)
+void gui_DrawMemoryAmounts(void)
 {
   void* free = NULL;
   uint24_t free_ram = os_MemChk(&free);
+  uint24_t edb_capacity = tool_EditBufferCapacity();
 
   gui_SetTextColor(g_color.background, g_color.list_text_normal);
   gfx_SetTextXY(216, 189);
   gfx_PrintString("EDB: ");
-  gfx_PrintUInt(editor->buffer_size, cutil_Log10(editor->buffer_size));
+  gfx_PrintUInt(edb_capacity, cutil_Log10(edb_capacity));
 
   gfx_SetTextXY(216, 200);
   gfx_PrintString("RAM: ");
@@ -347,11 +405,46 @@ void gui_DrawMainMenuBottomBar(void)
   gfx_PrintStringXY("ROM", 5, 226);
   gfx_PrintStringXY("RAM", 68, 226);
   gfx_PrintStringXY("Ports", 138, 226);
+  gfx_PrintStringXY("Search", 200, 226);
   gfx_PrintStringXY("About", 274, 226);
   return;
 }
 
 
+void gui_DrawSearchResultsBottomBar(const bool results_full)
+{
+  gfx_SetColor(g_color.bar);
+  gfx_FillRectangle_NoClip(0, 220, LCD_WIDTH, 20);
+  gui_SetTextColor(g_color.bar, g_color.bar_text);
+
+  if (results_full)
+    gfx_PrintStringXY("Only 100 variables listed", 5, 226);
+
+  return;
+}
+
+
+void gui_DrawSearchResultInfo(
+  const uint24_t first_match, const uint24_t num_matches
+)
+{
+  const uint24_t XPOS = 111;
+
+  gfx_SetColor(g_color.background);
+  gfx_FillRectangle_NoClip(107, 20, 105, 200);
+
+  gui_SetTextColor(g_color.background, g_color.list_text_normal);
+  gfx_PrintStringXY("Matches:", XPOS, 22);
+  gfx_SetTextXY(XPOS, 33);
+  gfx_PrintUInt(num_matches, cutil_Log10(num_matches));
+
+  gfx_PrintStringXY("First match:", XPOS, 55);
+  gfx_SetTextXY(XPOS, 66);
+  gfx_PrintUInt(first_match, cutil_Log10(first_match));
+  return;
+}
+
+
 void gui_DrawLocationColumn(const s_editor* const editor)
 {
   char address[7] = { '\0' };
@@ -383,76 +476,111 @@ void gui_DrawLocationColumn(const s_editor* const editor)
 }
 
 
-void gui_PrintData(const s_editor* const editor)
+void gui_InvalidateData(void)
 {
-  const uint8_t START_HEX_XPOS = 67;
-  const uint8_t START_YPOS = 22;
-  const uint8_t START_ASCII_XPOS = 237;
+  g_data_frames[0].valid = false;
+  g_data_frames[1].valid = false;
+  return;
+}
+
+
+void gui_SwapDraw(void)
+{
+  gfx_SwapDraw();
+  g_back_frame ^= 1;
+  return;
+}
 
-  uint24_t hex_xpos = START_HEX_XPOS;
-  uint8_t ypos = START_YPOS;
-  uint24_t ascii_xpos = START_ASCII_XPOS;
-  uint8_t* window_address = editor->base_address + editor->window_offset;
-  uint8_t* address = window_address;
-  uint24_t address_offset;
+
+void gui_BlitBuffer(void)
+{
+  gfx_BlitBuffer();
+  g_data_frames[g_back_frame ^ 1] = g_data_frames[g_back_frame];
+  return;
+}
+
+
+void gui_PrintData(const s_editor* const editor)
+{
+  s_data_frame* const frame = &g_data_frames[g_back_frame];
+  int24_t num_rows;
+  uint24_t offset = editor->window_offset;
+  uint8_t value;
+  uint8_t style;
 
   // Take the minimum of the number of bytes that can fit onscreen and the
   // number of bytes in both segments of the edit buffer, starting from the
   // window offset.
   uint8_t count = get_num_bytes_onscreen(editor);
 
-  gfx_SetColor(g_color.background);
-  gfx_FillRectangle_NoClip(START_HEX_XPOS - 5, START_YPOS - 2, 168, 200);
-  gfx_SetColor(g_color.editor_side_panel);
-  gfx_FillRectangle_NoClip(START_ASCII_XPOS - 5, START_YPOS - 2, 88, 200);
-
-  for (uint8_t idx = 0; idx < count; idx++)
+  // The rows that are still onscreen after a scroll are moved instead of being
+  // drawn again.
+  if (frame->valid && frame->window_offset != editor->window_offset)
   {
-    address_offset = address - editor->base_address;
-
-    if (address_offset == editor->near_size)
-      address = editor->base_address + editor->buffer_size - editor->far_size;
-
-    gui_SetTextColor(g_color.background, g_color.editor_text_normal);
+    num_rows = (
+      ((int24_t)editor->window_offset - (int24_t)frame->window_offset)
+      / G_COLS_ONSCREEN
+    );
 
     if (
-      address_offset >= (editor->near_size - editor->selection_size)
-      && address_offset < editor->near_size
+      (editor->window_offset - frame->window_offset) % G_COLS_ONSCREEN
+      || num_rows >= G_ROWS_ONSCREEN
+      || num_rows <= -G_ROWS_ONSCREEN
     )
-    {
-      gfx_SetColor(g_color.editor_cursor);
-      gfx_FillRectangle_NoClip(
-        hex_xpos - 1, ypos - 1, HEX_COL_WIDTH, ROW_HEIGHT
-      );
-      gfx_FillRectangle_NoClip(
-        ascii_xpos - 1, ypos - 1, ASCII_COL_WIDTH, ROW_HEIGHT
-      );
-      gui_SetTextColor(g_color.editor_cursor, g_color.editor_text_selected);
-    }
+      frame->valid = false;
+    else
+      shift_data_rows(frame, num_rows);
+  }
 
-    if (editor->window_offset + idx + 1 == editor->near_size)
-    {
-      gfx_SetColor(g_color.editor_text_normal);
-      gfx_HorizLine_NoClip(
-        hex_xpos - 1 + (9 * !editor->high_nibble), ypos + G_FONT_HEIGHT + 1, 9
-      );
-    }
+  if (!frame->valid)
+  {
+    gfx_SetColor(g_color.background);
+    gfx_FillRectangle_NoClip(DATA_HEX_XPOS - 5, DATA_YPOS - 2, 168, 200);
+    gfx_SetColor(g_color.editor_side_panel);
+    gfx_FillRectangle_NoClip(DATA_ASCII_XPOS - 5, DATA_YPOS - 2, 88, 200);
+    memset(frame->values, 0, G_NUM_BYTES_ONSCREEN);
+    memset(frame->styles, CELL_EMPTY, G_NUM_BYTES_ONSCREEN);
+    frame->valid = true;
+  }
 
-    gfx_SetColor(g_color.editor_text_normal);
-    print_hex(*address, hex_xpos, ypos);
-    print_ascii(*address, ascii_xpos, ypos);
+  frame->window_offset = editor->window_offset;
 
-    hex_xpos += HEX_COL_WIDTH;
-    ascii_xpos += ASCII_COL_WIDTH;
+  // Only the cells that look different from what this buffer already shows
+  // are drawn, so moving the cursor redraws two cells.
+  for (uint8_t idx = 0; idx < G_NUM_BYTES_ONSCREEN; idx++)
+  {
+    value = 0;
+    style = CELL_EMPTY;
+
+    if (idx < count)
+    {
+      style = CELL_SHOWN;
+
+      // The bytes onscreen may span the gap or several pages. Ports that
+      // cannot be shown are drawn as dashes.
+      if (tool_ViewByte(editor, offset, &value))
+        style |= CELL_READABLE;
+      else
+        value = 0;
+
+      if (
+        offset >= (editor->near_size - editor->selection_size)
+        && offset < editor->near_size
+      )
+        style |= CELL_SELECTED;
+
+      if (offset + 1 == editor->near_size)
+        style |= (editor->high_nibble ? CELL_CURSOR_HIGH : CELL_CURSOR_LOW);
+    }
 
-    if (idx && ((idx % G_COLS_ONSCREEN) == (G_COLS_ONSCREEN - 1)))
+    if (style != frame->styles[idx] || value != frame->values[idx])
     {
-      hex_xpos = START_HEX_XPOS;
-      ascii_xpos = START_ASCII_XPOS;
-      ypos += ROW_HEIGHT;
+      draw_data_cell(idx, value, style);
+      frame->styles[idx] = style;
+      frame->values[idx] = value;
     }
 
-    address++;
+    offset++;
   }
 
   return;
@@ -470,7 +598,7 @@ void gui_DrawTitleBar(const s_editor* const editor)
 
   gfx_SetTextXY(5, 6);
 
-  if (editor->num_changes)
+  if (editor->num_changes || editor->undo_evicted)
     gfx_PrintString("* ");
 
   if (editor->is_tios_var)
@@ -486,9 +614,30 @@ void gui_DrawTitleBar(const s_editor* const editor)
 
   gui_PrintText(name);
 
+  // Each open tab is marked under the name, and the active tab's mark is
+  // brighter.
+  if (tool_NumTabs() > 1)
+  {
+    for (uint8_t idx = 0; idx < tool_NumTabs(); idx++)
+    {
+      gfx_SetColor(
+        idx == tool_ActiveTab() ? g_color.bar_text : g_color.bar_text_dark
+      );
+      gfx_FillRectangle_NoClip(5 + (idx * 8), 15, 6, 2);
+    }
+  }
+
   gfx_SetTextXY(90, 6);
-  gfx_PrintUInt(editor->data_size, cutil_Log10(editor->data_size));
-  gfx_PrintString(" B");
+
+  // The size of the ports region never changes, so its place is used to show
+  // that the ports snapshot is active.
+  if (tool_PortsSnapshotActive(editor))
+    gfx_PrintString("Snapshot");
+  else
+  {
+    gfx_PrintUInt(editor->data_size, cutil_Log10(editor->data_size));
+    gfx_PrintString(" B");
+  }
 
   gfx_SetTextXY(184, 6);
   gfx_PrintUInt(editor->selection_size, 3);
@@ -520,7 +669,7 @@ void gui_DrawToolBar(const s_editor* const editor)
 
   const uint8_t NUM_SELECTION_INACTIVE_TOOLS = 5;
   const s_toolbar_tool SELECTION_INACTIVE_TOOLS[] = {
-    { .name = "Find", .xpos = 5, .func = tool_FindPhrase },
+    { .name = "Find", .xpos = 5, .func = tool_FindNextPhrase },
     { .name = "Insert", .xpos = 62, .func = tool_InsertBytes },
     { .name = "Goto", .xpos = 138, .func = tool_Goto },
     { .name = "Undo", .xpos = 224, .func = tool_UndoLastAction },
@@ -537,6 +686,8 @@ void gui_DrawToolBar(const s_editor* const editor)
   const s_toolbar_tool* tools = SELECTION_INACTIVE_TOOLS;
   uint8_t num_tools = NUM_SELECTION_INACTIVE_TOOLS;
   uint24_t decimal;
+  uint8_t value;
+  bool readable;
 
   gfx_SetColor(g_color.bar);
   gfx_FillRectangle_NoClip(0, 220, LCD_WIDTH, 20);
@@ -549,21 +700,23 @@ void gui_DrawToolBar(const s_editor* const editor)
 
     if (editor->near_size && editor->selection_size <= sizeof(uint24_t))
     {
-      gfx_SetTextFGColor(g_color.bar_text);
-      gfx_PrintStringXY("Decimal: ", 5, 226);
       decimal = 0;
+      readable = true;
 
-      for (uint8_t idx = 0; idx < editor->selection_size; idx++)
+      for (uint8_t idx = 0; idx < editor->selection_size && readable; idx++)
       {
-        decimal += (
-          *(
-            editor->base_address + editor->near_size
-            - editor->selection_size + idx
-          ) << (8 * idx)
+        readable = tool_ViewByte(
+          editor, editor->near_size - editor->selection_size + idx, &value
         );
+        decimal += value << (8 * idx);
       }
 
-      gfx_PrintUInt(decimal, cutil_Log10(decimal));
+      if (readable)
+      {
+        gfx_SetTextFGColor(g_color.bar_text);
+        gfx_PrintStringXY("Decimal: ", 5, 226);
+        gfx_PrintUInt(decimal, cutil_Log10(decimal));
+      }
     }
   }
 
@@ -577,6 +730,16 @@ void gui_DrawToolBar(const s_editor* const editor)
     gfx_PrintStringXY(tools[idx].name, tools[idx].xpos, 226);
   }
 
+  // The number of changes that can be undone is shown before "Undo."
+  if (!editor->selection_active && editor->undo_buffer_active)
+  {
+    gfx_SetTextFGColor(g_color.bar_text_dark);
+    gfx_SetTextXY(
+      220 - (cutil_Log10(editor->num_changes) * gfx_GetCharWidth('0')), 226
+    );
+    gfx_PrintUInt(editor->num_changes, cutil_Log10(editor->num_changes));
+  }
+
   return;
 }
 
@@ -596,19 +759,138 @@ void gui_DrawFindPromptMessage(const char* const message)
 
 
 void gui_DrawFindPhraseToolbar(
-  const uint8_t match_idx, const uint8_t num_matches
+  const s_editor* const editor, const uint24_t match, const bool replaceable
 )
 {
-  uint24_t actual_match_idx = match_idx + (num_matches ? 1 : 0);
+  char address[7] = { '\0' };
 
   gfx_SetColor(g_color.bar);
   gfx_FillRectangle_NoClip(0, 220, LCD_WIDTH, 20);
   gui_SetTextColor(g_color.bar, g_color.bar_text);
 
-  gfx_SetTextXY(5, 226);
-  gfx_PrintUInt(actual_match_idx, cutil_Log10(actual_match_idx));
-  gfx_PrintString(" / ");
-  gfx_PrintUInt(num_matches, cutil_Log10(num_matches));
+  // The match is located the same way as in the location column.
+  gfx_PrintStringXY("Match at ", 5, 226);
+
+  if (editor->location_col_mode == 'a')
+  {
+    cutil_UintToHex(address, (uint24_t)editor->base_address + match);
+    gfx_PrintString(address);
+  }
+  else
+    gfx_PrintUInt(match, cutil_Log10(match));
+
+  if (!replaceable)
+    gfx_SetTextFGColor(g_color.bar_text_dark);
+
+  gfx_PrintStringXY("Replace", 262, 226);
+  return;
+}
+
+
+void gui_DrawSignatureToolbar(
+  const s_editor* const editor,
+  const uint24_t match,
+  const char* const name,
+  const uint8_t signature,
+  const uint8_t hit,
+  const uint8_t num_hits,
+  const bool more_hits
+)
+{
+  char address[7] = { '\0' };
+  uint24_t width;
+
+  gfx_SetColor(g_color.bar);
+  gfx_FillRectangle_NoClip(0, 220, LCD_WIDTH, 20);
+  gui_SetTextColor(g_color.bar, g_color.bar_text);
+
+  // The hit is located the same way as in the location column.
+  if (name)
+    gfx_PrintStringXY(name, 5, 226);
+  else
+  {
+    gfx_PrintStringXY("Sig ", 5, 226);
+    gfx_PrintUInt(signature, cutil_Log10(signature));
+  }
+
+  gfx_PrintString(" at ");
+
+  if (editor->location_col_mode == 'a')
+  {
+    cutil_UintToHex(address, (uint24_t)editor->base_address + match);
+    gfx_PrintString(address);
+  }
+  else
+    gfx_PrintUInt(match, cutil_Log10(match));
+
+  width = (
+    gfx_GetCharWidth('0') * (cutil_Log10(hit) + cutil_Log10(num_hits))
+    + gfx_GetCharWidth('/') + (more_hits ? gfx_GetCharWidth('+') : 0)
+  );
+  gfx_SetTextXY(315 - width, 226);
+  gfx_PrintUInt(hit, cutil_Log10(hit));
+  gfx_PrintChar('/');
+  gfx_PrintUInt(num_hits, cutil_Log10(num_hits));
+
+  if (more_hits)
+    gfx_PrintChar('+');
+
+  return;
+}
+
+
+void gui_DrawFindProgress(
+  const s_editor* const editor,
+  const uint24_t num_matches,
+  const uint24_t first_match,
+  const bool searching
+)
+{
+  char address[7] = { '\0' };
+
+  gfx_SetColor(g_color.bar);
+  gfx_FillRectangle_NoClip(196, 226, LCD_WIDTH - 196, 10);
+  gui_SetTextColor(g_color.bar, g_color.bar_text);
+  gfx_SetTextXY(197, 226);
+
+  if (!num_matches)
+    gfx_PrintString(searching ? "Searching..." : "0 matches");
+  else
+  {
+    // A "+" means that more matches may be found. The first match is located
+    // the same way as in the location column.
+    gfx_PrintUInt(num_matches, cutil_Log10(num_matches));
+    gfx_PrintString(searching ? "+ @" : " @");
+
+    if (editor->location_col_mode == 'a')
+    {
+      cutil_UintToHex(address, (uint24_t)editor->base_address + first_match);
+      gfx_PrintString(address);
+    }
+    else
+      gfx_PrintUInt(first_match, cutil_Log10(first_match));
+  }
+
+  gfx_BlitRectangle(1, 196, 226, LCD_WIDTH - 196, 10);
+  return;
+}
+
+
+void gui_DrawReplacedMessage(const uint24_t num_replaced)
+{
+  uint24_t width = (
+    cutil_Log10(num_replaced) * gfx_GetCharWidth('0')
+    + gfx_GetStringWidth(" replaced")
+  );
+
+  gfx_SetColor(g_color.bar);
+  gfx_FillRectangle_NoClip(220, 226, LCD_WIDTH - 220, 10);
+
+  gui_SetTextColor(g_color.bar, g_color.bar_text);
+  gfx_SetTextXY(315 - width, 226);
+  gfx_PrintUInt(num_replaced, cutil_Log10(num_replaced));
+  gfx_PrintString(" replaced");
+  gfx_BlitRectangle(1, 0, 220, LCD_WIDTH, 20);
   return;
 }
 
@@ -627,6 +909,46 @@ void gui_DrawSavePrompt(void)
 }
 
 
+void gui_SaveRAMWindow(const char* const title, const uint24_t shortfall)
+{
+  char msg[64] = "Saving unarchives the$variable. Free ";
+  char* digit = msg + strlen(msg) + cutil_Log10(shortfall);
+  uint24_t value = shortfall;
+
+  strcpy(digit, " more$bytes of RAM first.");
+
+  do {
+    *--digit = '0' + value % 10;
+    value /= 10;
+  } while (value);
+
+  gui_MessageWindowBlocking(title, msg);
+  return;
+}
+
+
+void gui_DrawRecoveryPrompt(const char* const name)
+{
+  gfx_FillScreen(g_color.background);
+  gfx_SetTextXY(5, 30);
+  gui_SetTextColor(g_color.background, g_color.list_text_normal);
+  gfx_PrintString("HexaEdit did not exit normally while");
+  gfx_SetTextXY(5, 39);
+  gfx_PrintString(name);
+  gfx_PrintString(" had unsaved edits.");
+
+  gfx_SetColor(g_color.bar);
+  gfx_FillRectangle_NoClip(0, 220, LCD_WIDTH, 20);
+  gui_SetTextColor(g_color.bar, g_color.bar_text);
+
+  gfx_PrintStringXY("Edits:", 5, 226);
+  gfx_PrintStringXY("Keep", 132, 226);
+  gfx_PrintStringXY("Undo", 226, 226);
+  gfx_PrintStringXY("Edit", 285, 226);
+  return;
+}
+
+
 void gui_DrawInputPrompt(
   const char* const prompt, const uint24_t input_field_width
 )
@@ -806,6 +1128,117 @@ static uint8_t get_num_bytes_onscreen(const s_editor* const editor)
 }
 
 
+static void shift_data_rows(
+  s_data_frame* const frame, const int24_t num_rows
+)
+{
+  const uint8_t NUM_BYTES_EXPOSED = (
+    (num_rows > 0 ? num_rows : -num_rows) * G_COLS_ONSCREEN
+  );
+  const uint8_t NUM_BYTES_SHIFTED = G_NUM_BYTES_ONSCREEN - NUM_BYTES_EXPOSED;
+
+  // Only the rows of data cells are shifted. The clip region is set back to
+  // the whole screen, which is where the rest of the program expects it.
+  gfx_SetClipRegion(
+    DATA_HEX_XPOS - 5,
+    DATA_YPOS - 1,
+    LCD_WIDTH,
+    DATA_YPOS - 1 + (G_ROWS_ONSCREEN * ROW_HEIGHT)
+  );
+
+  if (num_rows > 0)
+  {
+    gfx_ShiftUp(num_rows * ROW_HEIGHT);
+    memmove(
+      frame->values, frame->values + NUM_BYTES_EXPOSED, NUM_BYTES_SHIFTED
+    );
+    memmove(
+      frame->styles, frame->styles + NUM_BYTES_EXPOSED, NUM_BYTES_SHIFTED
+    );
+    memset(frame->styles + NUM_BYTES_SHIFTED, CELL_STALE, NUM_BYTES_EXPOSED);
+  }
+  else
+  {
+    gfx_ShiftDown(-num_rows * ROW_HEIGHT);
+    memmove(
+      frame->values + NUM_BYTES_EXPOSED, frame->values, NUM_BYTES_SHIFTED
+    );
+    memmove(
+      frame->styles + NUM_BYTES_EXPOSED, frame->styles, NUM_BYTES_SHIFTED
+    );
+    memset(frame->styles, CELL_STALE, NUM_BYTES_EXPOSED);
+  }
+
+  gfx_SetClipRegion(0, 0, LCD_WIDTH, LCD_HEIGHT);
+  return;
+}
+
+
+static void draw_data_cell(
+  const uint8_t idx,
+  const uint8_t value,
+  const uint8_t style
+)
+{
+  const uint24_t hex_xpos = (
+    DATA_HEX_XPOS + ((idx % G_COLS_ONSCREEN) * HEX_COL_WIDTH)
+  );
+  const uint24_t ascii_xpos = (
+    DATA_ASCII_XPOS + ((idx % G_COLS_ONSCREEN) * ASCII_COL_WIDTH)
+  );
+  const uint8_t ypos = DATA_YPOS + ((idx / G_COLS_ONSCREEN) * ROW_HEIGHT);
+
+  // The cell's background covers everything that was drawn in the cell.
+  if (style & CELL_SELECTED)
+  {
+    gfx_SetColor(g_color.editor_cursor);
+    gfx_FillRectangle_NoClip(
+      hex_xpos - 1, ypos - 1, HEX_COL_WIDTH, ROW_HEIGHT
+    );
+    gfx_FillRectangle_NoClip(
+      ascii_xpos - 1, ypos - 1, ASCII_COL_WIDTH, ROW_HEIGHT
+    );
+    gui_SetTextColor(g_color.editor_cursor, g_color.editor_text_selected);
+  }
+  else
+  {
+    gfx_SetColor(g_color.background);
+    gfx_FillRectangle_NoClip(
+      hex_xpos - 1, ypos - 1, HEX_COL_WIDTH, ROW_HEIGHT
+    );
+    gfx_SetColor(g_color.editor_side_panel);
+    gfx_FillRectangle_NoClip(
+      ascii_xpos - 1, ypos - 1, ASCII_COL_WIDTH, ROW_HEIGHT
+    );
+    gui_SetTextColor(g_color.background, g_color.editor_text_normal);
+  }
+
+  if (!(style & CELL_SHOWN))
+    return;
+
+  gfx_SetColor(g_color.editor_text_normal);
+
+  if (style & (CELL_CURSOR_HIGH | CELL_CURSOR_LOW))
+  {
+    gfx_HorizLine_NoClip(
+      hex_xpos - 1 + (style & CELL_CURSOR_LOW ? 9 : 0),
+      ypos + G_FONT_HEIGHT + 1,
+      9
+    );
+  }
+
+  if (style & CELL_READABLE)
+  {
+    print_hex(value, hex_xpos, ypos);
+    print_ascii(value, ascii_xpos, ypos);
+  }
+  else
+    gfx_PrintStringXY("--", hex_xpos, ypos);
+
+  return;
+}
+
+
 static void print_text_wrap(const char* const text)
 {
   const char* c = text;
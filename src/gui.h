@@ -61,7 +61,7 @@ void gui_EraseHEVATEntryInfo(void);
 
 void gui_DrawHEVATEntryInfo(void* vatptr);
 
-void gui_DrawMemoryAmounts(const s_editor* const editor);
+void gui_DrawMemoryAmounts(void);
 
 void gui_DrawMainMenuTopBar(uint24_t num_list_items);
 
@@ -69,8 +69,24 @@ void gui_DrawMainMenuListDividers(void);
 
 void gui_DrawMainMenuBottomBar(void);
 
+void gui_DrawSearchResultsBottomBar(const bool results_full);
+
+void gui_DrawSearchResultInfo(
+  const uint24_t first_match, const uint24_t num_matches
+);
+
 void gui_DrawLocationColumn(const s_editor* const editor);
 
+// The data cells are only drawn where they have changed since they were last
+// drawn to the buffer. Anything else that draws over them must be followed by
+// gui_InvalidateData(), and the buffers must be swapped or blitted with
+// gui_SwapDraw() and gui_BlitBuffer() while the data is onscreen.
+void gui_InvalidateData(void);
+
+void gui_SwapDraw(void);
+
+void gui_BlitBuffer(void);
+
 void gui_PrintData(const s_editor* const editor);
 
 void gui_DrawTitleBar(const s_editor* const editor);
@@ -80,11 +96,39 @@ void gui_DrawToolBar(const s_editor* const editor);
 void gui_DrawFindPromptMessage(const char* const message);
 
 void gui_DrawFindPhraseToolbar(
-  const uint8_t match_idx, const uint8_t num_matches
+  const s_editor* const editor, const uint24_t match, const bool replaceable
 );
 
+// <hit> counts from one. A "+" after <num_hits> means that more hits were
+// found than were kept. If there is no <name>, the signature is shown by its
+// number.
+void gui_DrawSignatureToolbar(
+  const s_editor* const editor,
+  const uint24_t match,
+  const char* const name,
+  const uint8_t signature,
+  const uint8_t hit,
+  const uint8_t num_hits,
+  const bool more_hits
+);
+
+void gui_DrawFindProgress(
+  const s_editor* const editor,
+  const uint24_t num_matches,
+  const uint24_t first_match,
+  const bool searching
+);
+
+void gui_DrawReplacedMessage(const uint24_t num_replaced);
+
 void gui_DrawSavePrompt(void);
 
+// Tells the user how many more bytes of RAM, <shortfall>, must be freed to save
+// the variable.
+void gui_SaveRAMWindow(const char* const title, const uint24_t shortfall);
+
+void gui_DrawRecoveryPrompt(const char* const name);
+
 void gui_DrawInputPrompt(
   const char* const prompt, const uint24_t input_field_width
 );
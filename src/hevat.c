@@ -52,6 +52,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define MAX_NUM_RECENTS          (15)
 #define MAX_NUM_HEVAT_ENTRIES    (1015)
+#define MAX_NUM_SEARCH_RESULTS   (100)
+#define MAX_MATCHES_PER_SCAN     (16)
 
 
 const char* HEVAT__GROUP_NAMES[HEVAT__NUM_GROUPS] = {
@@ -68,6 +70,15 @@ static uint24_t g_num_vatptrs = 0;
 // Holds the number of entries for a given group index.
 static uint24_t g_num_entries[HEVAT__NUM_GROUPS] = { 0 };
 
+// Holds the variables found by the last search of every variable.
+static struct
+{
+  void* vatptr;
+  uint24_t first_match;
+  uint24_t num_matches;
+} g_search_results[MAX_NUM_SEARCH_RESULTS];
+static uint24_t g_num_search_results = 0;
+
 
 // =============================================================================
 // STATIC FUNCTION DECLARATIONS
@@ -124,6 +135,21 @@ static void get_variable_name(
 );
 
 
+// Description: Counts the matches of <phrase> in <size> bytes of data.
+// Pre:         <mask> may be NULL. If it is not, <phrase> must already be
+//              ANDed with it.
+// Post:        Number of matches returned, and the offset of the first match
+//              is in <first_match> if there are any.
+static uint24_t count_matches(
+  const uint8_t* data,
+  const uint24_t size,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t* const first_match
+);
+
+
 static char hex_char(uint8_t nibble)
 {
   nibble &= 0x0F;
@@ -602,6 +628,94 @@ bool hevat_GetVarInfoByNameAndType(
 }
 
 
+uint24_t hevat_FindPhrase(
+  const uint8_t phrase[], const uint8_t mask[], const uint8_t length
+)
+{
+CCDBG_BEGINBLOCK("hevat_FindPhrase");
+
+  s_calc_var var;
+  uint24_t size;
+  uint24_t first_match;
+  uint24_t num_matches;
+
+  g_num_search_results = 0;
+
+  // The Recents group only repeats variables from the other groups, so it is
+  // skipped. Each variable is searched where it is, in RAM or in flash.
+  for (
+    uint8_t group_idx = HEVAT__APPVAR;
+    group_idx < HEVAT__NUM_GROUPS;
+    group_idx++
+  )
+  {
+    for (uint24_t idx = 0; idx < g_num_entries[group_idx]; idx++)
+    {
+      if (g_num_search_results == MAX_NUM_SEARCH_RESULTS)
+        break;
+
+      var.vatptr = hevat_Ptr(group_idx, idx);
+
+      if (!hevat_GetVarInfoByVAT(&var))
+        continue;
+
+      // Offsets are given the same way that the editor gives them, which
+      // leaves out the size bytes at the start of named variables.
+      size = var.size;
+
+      if (var.named)
+      {
+        var.data += 2;
+        size -= 2;
+      }
+
+      num_matches = count_matches(
+        var.data, size, phrase, mask, length, &first_match
+      );
+
+      if (num_matches)
+      {
+        g_search_results[g_num_search_results].vatptr = var.vatptr;
+        g_search_results[g_num_search_results].first_match = first_match;
+        g_search_results[g_num_search_results].num_matches = num_matches;
+        g_num_search_results++;
+      }
+    }
+  }
+
+CCDBG_DUMP_UINT(g_num_search_results);
+CCDBG_ENDBLOCK();
+
+  return g_num_search_results;
+}
+
+
+uint24_t hevat_NumSearchResults(void)
+{
+  return g_num_search_results;
+}
+
+
+bool hevat_SearchResultsFull(void)
+{
+  return g_num_search_results == MAX_NUM_SEARCH_RESULTS;
+}
+
+
+void* hevat_SearchResult(
+  const uint24_t index,
+  uint24_t* const first_match,
+  uint24_t* const num_matches
+)
+{
+  assert(index < g_num_search_results);
+
+  *first_match = g_search_results[index].first_match;
+  *num_matches = g_search_results[index].num_matches;
+  return g_search_results[index].vatptr;
+}
+
+
 void hevat_GetHEVATGroupNames(char buffer[20], uint24_t index)
 {
   assert(index < HEVAT__NUM_GROUPS);
@@ -704,6 +818,22 @@ void hevat_GetOtherVariableName(char buffer[20], uint24_t index)
   return;
 }
 
+void hevat_GetSearchResultVariableName(char buffer[20], uint24_t index)
+{
+  s_calc_var var;
+
+  assert(index < g_num_search_results);
+
+  var.vatptr = g_search_results[index].vatptr;
+
+  if (hevat_GetVarInfoByVAT(&var))
+    hevat_VarNameToASCII(buffer, (const uint8_t*)var.name, var.named);
+  else
+    assert(false);
+
+  return;
+}
+
 
 // =============================================================================
 // STATIC FUNCTION DEFINITIONS
@@ -856,10 +986,13 @@ CCDBG_BEGINBLOCK("load_vatptr_entries");
     last_entry = entry;
     entry = os_NextSymEntry(entry, &os_var_type, &name_length, name, &data);
 
-    // Do not load the VAT entry for HexaEdit's edit buffer appvar.
+    // Do not load the VAT entries for HexaEdit's internal appvars.
     if (
       os_var_type == OS_TYPE_APPVAR
-      && !strncmp(G_EDIT_BUFFER_APPVAR_NAME, name, min(8, name_length))
+      && name_length >= strlen(G_INTERNAL_APPVAR_PREFIX)
+      && !strncmp(
+        G_INTERNAL_APPVAR_PREFIX, name, strlen(G_INTERNAL_APPVAR_PREFIX)
+      )
     )
     {
       continue;
@@ -982,3 +1115,51 @@ CCDBG_ENDBLOCK();
 
   return;
 }
+
+
+static uint24_t count_matches(
+  const uint8_t* data,
+  const uint24_t size,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t* const first_match
+)
+{
+  const uint8_t* const last = data + size - 1;
+  const uint8_t* start = data;
+  uint24_t matches[MAX_MATCHES_PER_SCAN];
+  uint24_t num_matches = 0;
+  uint8_t num_found;
+
+  if (size < length)
+    return 0;
+
+  do
+  {
+    if (mask)
+    {
+      num_found = asmutil_FindMaskedPhrase(
+        start, last, phrase, mask, length, matches, MAX_MATCHES_PER_SCAN
+      );
+    }
+    else
+    {
+      num_found = asmutil_FindPhrase(
+        start, last, phrase, length, matches, MAX_MATCHES_PER_SCAN
+      );
+    }
+
+    if (num_found && !num_matches)
+      *first_match = matches[0] - (uint24_t)data;
+
+    num_matches += num_found;
+
+    // The matches do not overlap, so the next ones start after the last one.
+    if (num_found)
+      start = (const uint8_t*)matches[num_found - 1] + length;
+  }
+  while (num_found == MAX_MATCHES_PER_SCAN && start + length - 1 <= last);
+
+  return num_matches;
+}
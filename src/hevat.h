@@ -188,6 +188,35 @@ void hevat_AddRecent(void* vatptr);
 bool hevat_GetVarInfoByVAT(s_calc_var* const var);
 
 
+// Description: Searches the data of every variable in the HEVAT for <phrase>
+//              and keeps the variables that have matches as search results.
+// Pre:         HEVAT should be loaded. <mask> may be NULL. If it is not,
+//              <phrase> must already be ANDed with it.
+// Post:        Number of search results returned. Only the first 100
+//              variables with matches are kept.
+uint24_t hevat_FindPhrase(
+  const uint8_t phrase[], const uint8_t mask[], const uint8_t length
+);
+
+
+uint24_t hevat_NumSearchResults(void);
+
+
+// Description: Tells if the last search stopped early because it had found
+//              as many variables as it can keep.
+bool hevat_SearchResultsFull(void);
+
+
+// Description: Returns the VAT pointer of the search result at <index>, and
+//              gives the offset of its first match and its number of matches.
+// Pre:         <index> must be less than hevat_NumSearchResults().
+void* hevat_SearchResult(
+  const uint24_t index,
+  uint24_t* const first_match,
+  uint24_t* const num_matches
+);
+
+
 void hevat_VarNameToASCII(char buffer[20], const uint8_t name[8], bool named);
 
 
@@ -230,5 +259,7 @@ void hevat_GetGroupVariableName(char buffer[20], uint24_t index);
 
 void hevat_GetOtherVariableName(char buffer[20], uint24_t index);
 
+void hevat_GetSearchResultVariableName(char buffer[20], uint24_t index);
+
 
 #endif
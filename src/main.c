@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ccdbg/ccdbg.h"
 #include "defines.h"
+#include "editor.h"
 #include "gui.h"
 #include "main_gui.h"
 #include "main_hl.h"
@@ -88,6 +89,7 @@ CCDBG_BEGINBLOCK("main");
     .tios_var_type = 0,
     .undo_buffer_active = false,
     .num_changes = 0,
+    .undo_evicted = false,
     .base_address = NULL,
     .data_size = 0,
     .buffer_size = 0,
@@ -96,6 +98,10 @@ CCDBG_BEGINBLOCK("main");
     .writing_mode = 'x',
     .near_size = 0,
     .far_size = 0,
+    .gap_offset = 0,
+    .paged = false,
+    .in_place = false,
+    .var_data = NULL,
     .selection_size = 1,
     .selection_active = false,
     .high_nibble = true
@@ -135,6 +141,10 @@ CCDBG_PUTS("Created edit buffer.");
 
   open_gfx();
 
+  // Edits made in place are still in their variables if HexaEdit did not exit
+  // normally last time.
+  editor_RecoverJournals(&editor);
+
   if (headless_start)
     retval = mainhl_RunEditor(&editor);
   else
@@ -142,6 +152,7 @@ CCDBG_PUTS("Created edit buffer.");
 
   close_gfx();
   tool_DeleteEditBuffer();
+  tool_DeleteJournals();
 
 CCDBG_ENDBLOCK();
 
@@ -63,6 +63,12 @@ static void set_routine_to_get_item_names_for_variables_list(
 );
 
 
+// Description: Searches every variable for a phrase that the user enters and
+//              lists the variables that have matches. Opening one of them
+//              starts the editor in the find viewer.
+static void search_all_vars(s_editor* const editor);
+
+
 // =============================================================================
 // PUBLIC FUNCTION DEFINITIONS
 // =============================================================================
@@ -118,7 +124,7 @@ CCDBG_PUTS("After initialization");
     {
       gfx_FillScreen(g_color.background);
       gui_DrawMainMenuListDividers();
-      gui_DrawMemoryAmounts(editor);
+      gui_DrawMemoryAmounts();
       gui_DrawMainMenuBottomBar();
     }
 
@@ -184,6 +190,12 @@ CCDBG_PUTS("Before HEVAT group wrangling.");
       redraw_all = true;
     }
 
+    if (keypad_SinglePressExclusive(kb_KeyTrace))
+    {
+      search_all_vars(editor);
+      redraw_all = true;
+    }
+
     if (keypad_SinglePressExclusive(kb_KeyGraph))
     {
       gui_MessageWindowBlocking(
@@ -195,7 +207,16 @@ CCDBG_PUTS("Before HEVAT group wrangling.");
     }
 
     if (keypad_SinglePressExclusive(kb_KeyClear))
-      quit = true;
+    {
+      // The program cannot quit while tabs are open, so return to them.
+      if (tool_NumTabs())
+      {
+        editor_ResumeTabs(editor);
+        redraw_all = true;
+      }
+      else
+        quit = true;
+    }
 
     if (keypad_KeyPressedOrHeld(kb_KeyUp, KEYPRESS_DELAY_THRESHOLD))
       list_DecrementCursorIndex(active_list);
@@ -283,3 +304,122 @@ static void set_routine_to_get_item_names_for_variables_list(
   list_SetRoutineToGetItemNames(list, routine_list[hevat_group_idx]);
   return;
 }
+
+
+static void search_all_vars(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("search_all_vars");
+
+  const uint8_t KEYPRESS_DELAY_THRESHOLD = 8;
+
+  list results_list;
+  void* vatptr;
+  uint8_t phrase[8];
+  uint8_t mask[8];
+  const uint8_t* phrase_mask = NULL;
+  uint24_t first_match;
+  uint24_t num_matches;
+  uint8_t phrase_length;
+  bool masked;
+  bool redraw_all = true;
+
+  if (!editor_PhrasePrompt(NULL, phrase, mask, &phrase_length, &masked))
+  {
+CCDBG_ENDBLOCK();
+    return;
+  }
+
+  if (masked)
+    phrase_mask = mask;
+
+  gui_DrawFindPromptMessage("Searching...");
+
+  if (!hevat_FindPhrase(phrase, phrase_mask, phrase_length))
+  {
+    gui_DrawFindPromptMessage("0 matches");
+
+    while (true)
+    {
+      keypad_IdleKeypadBlock();
+
+      if (keypad_SinglePressExclusive(kb_KeyClear))
+        break;
+    }
+
+CCDBG_ENDBLOCK();
+    return;
+  }
+
+  list_Initialize(&results_list);
+  list_SetPosition(&results_list, 2, 22);
+  list_SetTotalItemCount(&results_list, hevat_NumSearchResults());
+  list_SetRoutineToGetItemNames(
+    &results_list, &hevat_GetSearchResultVariableName
+  );
+
+  while (true)
+  {
+    if (redraw_all)
+    {
+      gfx_FillScreen(g_color.background);
+      gui_DrawMainMenuListDividers();
+      gui_DrawMemoryAmounts();
+      gui_DrawSearchResultsBottomBar(hevat_SearchResultsFull());
+    }
+
+    gui_DrawMainMenuTopBar(list_GetTotalItemCount(&results_list));
+    gui_DrawActiveList(&results_list);
+
+    vatptr = hevat_SearchResult(
+      list_GetCursorIndex(&results_list), &first_match, &num_matches
+    );
+    gui_DrawSearchResultInfo(first_match, num_matches);
+    gui_EraseHEVATEntryInfo();
+    gui_DrawHEVATEntryInfo(vatptr);
+
+    if (redraw_all)
+    {
+      gfx_BlitBuffer();
+      redraw_all = false;
+    }
+    else
+      gfx_SwapDraw();
+
+    keypad_IdleKeypadBlock();
+
+    if (
+      keypad_SinglePressExclusive(kb_KeyClear)
+      || keypad_SinglePressExclusive(kb_KeyLeft)
+    )
+    {
+      break;
+    }
+
+    if (keypad_KeyPressedOrHeld(kb_KeyUp, KEYPRESS_DELAY_THRESHOLD))
+      list_DecrementCursorIndex(&results_list);
+
+    if (keypad_KeyPressedOrHeld(kb_KeyDown, KEYPRESS_DELAY_THRESHOLD))
+      list_IncrementCursorIndex(&results_list);
+
+    if (
+      keypad_SinglePressExclusive(kb_Key2nd)
+      || keypad_SinglePressExclusive(kb_KeyEnter)
+      || keypad_SinglePressExclusive(kb_KeyRight)
+    )
+    {
+      if (
+        editor_OpenVarEditorAtMatch(
+          editor, vatptr, phrase, phrase_mask, phrase_length, first_match
+        )
+      )
+      {
+        hevat_AddRecent(vatptr);
+      }
+
+      redraw_all = true;
+    }
+  }
+
+CCDBG_ENDBLOCK();
+  return;
+}
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "editor.h"
 #include "gui.h"
 #include "main_hl.h"
+#include "tools.h"
 
 
 enum HEADER_FLAGS : uint8_t
@@ -352,6 +353,11 @@ CCDBG_DUMP_UINT(var_opened);
     }
   }
 
+  // There is no main menu to open another tab from, so the editor stays open
+  // until every tab is closed.
+  while (tool_NumTabs())
+    editor_ResumeTabs(editor);
+
   ti_DeleteVar(OS_VAR_ANS, OS_TYPE_STR);
 CCDBG_ENDBLOCK();
 
@@ -50,47 +50,795 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define MAX_VAR_DATA_SIZE (65504)
 
-
+// Paged editors copy the variable's data into the edit buffer one page at a
+// time, and only when a page is first modified.
+#define EDIT_PAGE_SIZE     (256)
+#define MAX_NUM_EDIT_PAGES (MAX_VAR_DATA_SIZE / EDIT_PAGE_SIZE + 1)
+
+// Modified data is tracked as at most this many ranges. Beyond that, the two
+// closest ranges are merged.
+#define MAX_NUM_DIRTY_RANGES (8)
+
+// The most undo stack space any single undo record takes: a header with a
+// full offset delta, followed by a selection's worth of bytes.
+#define MAX_UNDO_RECORD_SIZE (3 + sizeof(uint24_t) + G_MAX_SELECTION_SIZE)
+
+// Evicting the oldest undo records moves the rest of them, so at least this
+// many bytes are freed at once.
+#define UNDO_EVICTION_SIZE (256)
+
+// A tab's journal is brought up to date with its undo records after this many
+// changes, and whenever the tab stops being shown.
+#define JOURNAL_BATCH_SIZE (16)
+#define NO_JOURNAL         (0xff)
+
+// Deletions, cuts, and pastes of at least this many bytes keep their old bytes
+// in the tab's spill appvar, so they do not crowd the smaller records out of
+// the undo stack.
+#define UNDO_SPILL_SIZE (32)
+#define NO_SPILL        (0xff)
+
+// Searching backward finds the last match in each chunk of this many bytes by
+// searching the chunk forward.
+#define FIND_CHUNK_SIZE (1024)
+
+// The signatures in the signatures appvar are found in one pass over the data
+// by an Aho-Corasick automaton. Its nodes are numbered with a uint8_t, and the
+// root is node 0. Only the first MAX_NUM_SIGNATURE_HITS hits are kept.
+#define MAX_NUM_SIGNATURES      (16)
+#define MAX_SIGNATURE_LENGTH    (16)
+#define MAX_NUM_SIGNATURE_NODES (255)
+#define MAX_NUM_SIGNATURE_HITS  (255)
+
+// The number of entries in PORT_RANGES.
+#define NUM_PORT_RANGES (14)
+
+// Offset deltas from -127 to 127 are stored in one byte. Any other delta is
+// stored in full after this byte.
+#define UNDO_LONG_DELTA (0x80)
+
+// Gaps of up to 254 bytes between a replacement's matches are stored in one
+// byte. Any other gap is stored in full after this byte.
+#define REPLACE_LONG_GAP (0xff)
+
+
+// Every undo record starts with a header:
+//   code, number of nibbles or bytes, offset delta (1 or 4 bytes)
+// The delta is the record's offset minus the offset of the record before it,
+// so the offsets are recovered by walking back from <g_undo_offset>.
+// The header is followed by:
+//   UNDO_WRITE_*_NIBBLES, UNDO_WRITE_BYTES: the old value of each byte in the
+//     run, newest first. Consecutive writes extend the newest run instead of
+//     adding a record, and a run starts at its high or low nibble.
+//   UNDO_INSERT_BYTES: nothing.
+//   UNDO_PASTE_BYTES, UNDO_DELETE_OR_CUT_BYTES: the old bytes, in order.
+//   UNDO_PASTE_SPILLED_BYTES, UNDO_DELETE_OR_CUT_SPILLED_BYTES: the size of
+//     the old bytes in the spill appvar, where they are run-length encoded
+//     unless that would not make them smaller.
+//   UNDO_REPLACE_BYTES: an s_replace_header, the phrase, its replacement, and
+//     the gap from the end of each match to the start of the next. The number
+//     is the phrase's length, and the offset is the first match's.
+// The spill appvar holds the old bytes of the newest spilled record first, so
+// undoing it removes them from the appvar's start, and evicting the oldest
+// records removes theirs from its end.
+//
+// Undoing a change adds a redo record, which uses the same codes but records
+// one keystroke with an absolute offset:
+//   payload, offset (uint24_t), number of bytes, code
+// The payload is the byte's new value for writes, the pasted bytes for pastes,
+// the undo record's payload followed by its size for replacements, and nothing
+// otherwise. The code is the last byte, so the newest redo record
+// is found from <g_redo_sp>.
 enum UNDO_ACTION_CODES : uint8_t
 {
-  UNDO_WRITE_NIBBLE = 200,
-  UNDO_WRITE_BYTE,
+  UNDO_WRITE_HIGH_NIBBLES = 200,
+  UNDO_WRITE_LOW_NIBBLES,
+  UNDO_WRITE_BYTES,
   UNDO_INSERT_BYTES,
   UNDO_PASTE_BYTES,
-  UNDO_DELETE_OR_CUT_BYTES
+  UNDO_DELETE_OR_CUT_BYTES,
+  UNDO_PASTE_SPILLED_BYTES,
+  UNDO_DELETE_OR_CUT_SPILLED_BYTES,
+  UNDO_REPLACE_BYTES
 };
 
 
+typedef struct
+{
+  uint24_t start;
+  uint24_t end;
+} s_dirty_range;
+
+
+// A journal appvar holds a copy of its tab's undo records, exactly as they are
+// laid out in the undo stack, followed by this footer. Resizing an appvar adds
+// or removes bytes at its start, like pushing or popping undo records, so the
+// older records never move and only the changed ones are copied.
+typedef struct
+{
+  uint24_t undo_offset;
+  uint24_t var_size;
+  uint8_t var_type;
+  uint8_t name_length;
+  char name[8];
+} s_journal_footer;
+
+
+// The start of a replacement's undo record payload. <gaps_size> is the size of
+// the gaps at the end of the payload.
+typedef struct
+{
+  uint24_t gaps_size;
+  uint24_t num_matches;
+  uint8_t replacement_length;
+} s_replace_header;
+
+
+// A node of the signature automaton. <child> is the first of the node's
+// children, which are linked by <sibling>, and <fail> is the node for the
+// longest proper suffix of the node's bytes that is also in the automaton.
+// <signature> is the number of the signature that ends at the node, from one,
+// and <output> is the next node on the <fail> chain where a signature ends.
+// Zero means none for all of them, since the root cannot be a child.
+typedef struct
+{
+  uint8_t byte;
+  uint8_t child;
+  uint8_t sibling;
+  uint8_t fail;
+  uint8_t signature;
+  uint8_t output;
+} s_signature_node;
+
+
+typedef struct
+{
+  uint24_t offset;
+  uint8_t signature;
+} s_signature_hit;
+
+
+// A range of the ports region, from <start> up to but not including <end>,
+// whose bytes are accessed the way that <access> says.
+typedef struct
+{
+  uint24_t start;
+  uint24_t end;
+  uint8_t access;
+} s_port_range;
+
+
+// The state of a tab that is saved while another tab is active. The active
+// tab's state is kept in the file globals below instead, except for
+// <region_size>, the journal's state, and <spill>, which are always kept here.
+// <journal_synced> counts the undo stack bytes, from the top, that the journal
+// already matches, and <journal_size> is the size of the journal's image of the
+// undo stack.
+typedef struct
+{
+  uint24_t region_size;
+  uint8_t journal;
+  uint24_t journal_synced;
+  uint24_t journal_size;
+  uint8_t journal_pending;
+  uint8_t spill;
+  uint24_t undo_size;
+  uint24_t undo_offset;
+  uint24_t redo_size;
+  uint8_t page_slots[MAX_NUM_EDIT_PAGES];
+  uint8_t num_pages_loaded;
+  s_dirty_range dirty_ranges[MAX_NUM_DIRTY_RANGES + 1];
+  uint8_t num_dirty_ranges;
+} s_tab;
+
+
 // File globals. Do NOT use these outside of this file.
 static uint8_t g_cutcopy_buffer[G_MAX_SELECTION_SIZE];
 static uint8_t g_cutcopy_buffer_size = 0;
 
+// The bytes of an undo record being spilled, and the same bytes packed.
+static uint8_t g_spill_bytes[G_MAX_SELECTION_SIZE];
+static uint8_t g_spill_packed[G_MAX_SELECTION_SIZE];
+
 static uint8_t g_undo_stack[30000];
 static uint8_t* g_undo_sp = g_undo_stack + (sizeof g_undo_stack) - 1;
 
+// Each open tab gets an equal share of the undo stack, and keeps its records
+// at the top of its share. These bound the active tab's share.
+static uint8_t* g_undo_bottom = g_undo_stack;
+static uint8_t* g_undo_top = g_undo_stack + (sizeof g_undo_stack) - 1;
+
+// The offset of the newest undo record.
+static uint24_t g_undo_offset = 0;
+
+// The redo log grows up from <g_undo_bottom> toward the undo records, and
+// <g_redo_sp> points to the byte after its newest record. Any new change
+// discards it.
+static uint8_t* g_redo_sp = g_undo_stack;
+
+// For each page of a paged editor's data, the index of the edit buffer slot
+// holding the modified page plus one, or zero if the page is unmodified. Slots
+// are allocated from the end of the edit buffer.
+static uint8_t g_page_slots[MAX_NUM_EDIT_PAGES];
+static uint8_t g_num_page_slots = 0;
+static uint8_t g_num_pages_loaded = 0;
+
+// The ranges of the editor's data that differ from the variable, sorted and
+// non-overlapping. A range ends before <end>. The extra element is room for a
+// new range before it is merged.
+static s_dirty_range g_dirty_ranges[MAX_NUM_DIRTY_RANGES + 1];
+static uint8_t g_num_dirty_ranges = 0;
+
+// Each open tab owns a region of the edit buffer. The first tab's region is at
+// the end of the edit buffer, and each later tab's region is before the one of
+// the tab opened before it.
+static s_tab g_tabs[G_MAX_NUM_TABS];
+static uint8_t g_num_tabs = 0;
+static uint8_t g_active_tab = 0;
+
+static s_signature_node g_signature_nodes[MAX_NUM_SIGNATURE_NODES];
+static uint8_t g_num_signature_nodes = 0;
+static uint8_t g_signature_lengths[MAX_NUM_SIGNATURES];
+static uint8_t g_num_signatures = 0;
+
+// Most bytes do not continue a signature, so the root's transitions are looked
+// up in a table instead of its list of children.
+static uint8_t g_signature_root[256];
+
+// The first hits of the last scan, in order of offset.
+static s_signature_hit g_signature_hits[MAX_NUM_SIGNATURE_HITS];
+static uint8_t g_num_signature_hits = 0;
+
+// The registers of each port in the ports region, as offsets from
+// G_PORTS_BASE_ADDRESS and in order. The rest of the region is unmapped. Ports
+// that are not known to be safe to read are treated as having side effects.
+static const s_port_range PORT_RANGES[NUM_PORT_RANGES] = {
+  { 0x000000, 0x000100, PORT_READ_SAFE },          // Flash controller
+  { 0x010000, 0x010100, PORT_READ_SAFE },          // SHA-256
+  { 0x020000, 0x020400, PORT_READ_SIDE_EFFECTS },  // USB, which has FIFOs
+  { 0x030000, 0x031000, PORT_READ_SAFE },          // LCD controller
+  { 0x100000, 0x100100, PORT_READ_SAFE },          // Interrupt controller
+  { 0x110000, 0x110008, PORT_READ_SAFE },          // Watchdog
+  { 0x110008, 0x11000c, PORT_WRITE_ONLY },         // Watchdog restart
+  { 0x11000c, 0x110100, PORT_READ_SAFE },          // Watchdog
+  { 0x120000, 0x120100, PORT_READ_SAFE },          // Timers
+  { 0x130000, 0x130100, PORT_READ_SAFE },          // Real-time clock
+  { 0x140000, 0x140100, PORT_READ_SIDE_EFFECTS },  // Protected ports
+  { 0x150000, 0x150100, PORT_READ_SAFE },          // Keypad
+  { 0x160000, 0x160100, PORT_READ_SAFE },          // Backlight
+  { 0x180000, 0x180100, PORT_READ_SIDE_EFFECTS }   // SPI, which has a FIFO
+};
+
+// The bytes that were onscreen in the ports editor when the snapshot was taken.
+// While the snapshot is active, they are shown instead of the ports.
+static uint8_t g_ports_snapshot[G_NUM_BYTES_ONSCREEN];
+static uint24_t g_ports_snapshot_offset = 0;
+static uint8_t g_ports_snapshot_size = 0;
+static bool g_ports_snapshot_active = false;
+
 
 // =============================================================================
 // STATIC FUNCTION DECLARATIONS
 // =============================================================================
 
 
-static bool archive_edit_buffer(void);
+// Description: Saves the active tab's state into its entry in <g_tabs>.
+static void save_tab(void);
+
+
+// Description: Makes <tab> the active tab and loads its saved state.
+// Post:        The page slots must still be counted by update_base_address().
+static void load_tab(const uint8_t tab);
+
+
+// Description: Returns the top of <tab>'s share of the undo stack.
+static uint8_t* undo_top(const uint8_t tab);
+
+
+// Description: Returns a pointer to the first byte of <tab>'s share of the
+//              undo stack.
+static uint8_t* undo_bottom(const uint8_t tab);
+
+
+// Description: Moves each open tab's undo records from <old_tops> to the top of
+//              its share of the undo stack, and its redo records from the
+//              bottom of its <old_share>-byte share to the bottom of its new
+//              share, after the number of shares changes.
+static void share_undo_stack(
+  uint8_t* const old_tops[], const uint24_t old_share
+);
+
+
+// Description: Returns the number of edit buffer bytes before <tab>'s region.
+static uint24_t region_offset(const uint8_t tab);
+
+
+// Description: Returns the number of edit buffer bytes owned by the tabs that
+//              are not active.
+static uint24_t other_regions_size(void);
+
+
+// Description: Resizes the active tab's region of the edit buffer. Bytes are
+//              added to or removed from the start of the region.
+// Post:        If successful, true returned.
+//              <editor->base_address> and <editor->buffer_size> updated.
+static bool resize_region(s_editor* const editor, const uint24_t size);
+
+
+// Description: Points the editor at the active tab's region of the edit
+//              buffer, which moves whenever a variable or the edit buffer is
+//              resized.
+static void update_base_address(s_editor* const editor);
+
 
+// Description: Looks up where the paged variable's data is now. Resizing a
+//              variable in RAM, or archiving one, can move it.
+static void update_var_data(s_editor* const editor);
 
-static bool shrink_edit_buffer(const s_editor* const editor);
 
+static bool shrink_edit_buffer(s_editor* const editor);
 
-static bool save_edited_var(s_calc_var* const var);
 
+// Description: Resizes <var> to the size of the editor's data where it is and
+//              copies the data into it straight from both sides of the gap.
+//              The variable only needs as much free RAM as it grows by.
+// Post:        If successful, true returned.
+static bool stream_var(s_editor* const editor, s_calc_var* const var);
 
+
+// Description: Returns true if there is <size> bytes of room between the redo
+//              log and the undo records.
 static bool undo_buffer_has_room(const uint24_t size);
 
 
+// Description: Returns true if the oldest undo records may be evicted to make
+//              room for new ones. Changes to memory areas and to variables
+//              edited in place can only be discarded by undoing them, so
+//              their records are never evicted.
+static bool can_evict_undo(const s_editor* const editor);
+
+
+// Description: Returns true if the undo record for any change is guaranteed to
+//              be added.
+static bool undo_record_fits(const s_editor* const editor);
+
+
+// Description: Makes <size> bytes of room for a new undo record, evicting the
+//              oldest records if can_evict_undo() is true.
+// Post:        If successful, true returned.
+//              <editor->num_changes> counts only the changes that can still be
+//              undone, and <editor->undo_evicted> is set if any were evicted.
+static bool make_undo_room(s_editor* const editor, const uint24_t size);
+
+
+static int8_t save_paged_var(s_editor* const editor, s_calc_var* const var);
+
+
+// Description: Writes the dirty ranges of the editor's data into <var>, which
+//              must be the same size as the data.
+// Post:        If successful, true returned.
+static bool patch_var(s_editor* const editor, s_calc_var* const var);
+
+
+// Description: Adds the range from <start> up to <end> to the dirty ranges.
+static void mark_dirty(const uint24_t start, const uint24_t end);
+
+
+// Description: Merges the dirty range at <idx> into the one before it.
+static void merge_dirty_ranges(const uint8_t idx);
+
+
+// Description: Places the cursor on <offset>, extending the selection back from
+//              it if one is set.
+// Pre:         <editor->data_size> must be set.
+// Post:        <editor->near_size> and <editor->far_size> set.
+static void set_cursor(s_editor* const editor, const uint24_t offset);
+
+
+// Description: Returns the logical offset at which the physically contiguous
+//              run of data containing <offset> ends.
+static uint24_t segment_end(const s_editor* const editor, const uint24_t offset);
+
+
+// Description: Determines if the edit buffer is, or can grow to, at least
+//              <size> bytes.
+static bool can_grow_edit_buffer(
+  const s_editor* const editor, const uint24_t size
+);
+
+
+// Description: Grows the edit buffer to at least <size> bytes. The edit buffer
+//              at least doubles in size when there is enough free RAM, and an
+//              unpaged buffer also gets G_EDIT_BUFFER_HEADROOM bytes of room
+//              for insertions.
+// Post:        If successful, true returned and <editor->base_address> and
+//              <editor->buffer_size> updated.
+static bool grow_edit_buffer(s_editor* const editor, const uint24_t size);
+
+
+// Description: Determines if every page from <offset> to <offset> + <amount>
+//              is in the edit buffer or can be loaded into it.
+static bool pages_writable(
+  const s_editor* const editor, const uint24_t offset, const uint24_t amount
+);
+
+
+// Description: Determines if <num_new_pages> more pages can be loaded into the
+//              edit buffer.
+static bool pages_fit(
+  const s_editor* const editor, const uint24_t num_new_pages
+);
+
+
+// Description: Adds the pages from <offset> to <offset> + <amount> that are
+//              not in the edit buffer to <*num_new_pages>. <*next_page> is the
+//              first page that has not been counted yet, so each page is only
+//              counted once as long as the ranges are given in order.
+static void count_new_pages(
+  const uint24_t offset,
+  const uint24_t amount,
+  uint24_t* const next_page,
+  uint24_t* const num_new_pages
+);
+
+
+// Description: Copies every unmodified page from <offset> to <offset> +
+//              <amount> into a free slot in the edit buffer, growing the edit
+//              buffer if it has too few slots.
+// Pre:         pages_writable() must be true for the same range.
+static void load_pages(
+  s_editor* const editor, const uint24_t offset, const uint24_t amount
+);
+
+
+// Description: Determines if paged data and its modified pages fit in the edit
+//              buffer together, so that the data can be unpaged.
+static bool can_unpage(const s_editor* const editor);
+
+
+// Description: Copies all of the paged data into the edit buffer and switches
+//              the editor to the gap buffer, so the data can be resized.
+// Pre:         can_unpage() must be true.
+// Post:        <editor->paged> == false.
+static void unpage_data(s_editor* const editor);
+
+
+// Description: Restores the original value of every byte modified in place by
+//              walking the undo records from <record>, the newest, to <end>.
+//              <offset> is the newest record's offset. The records themselves
+//              are left untouched.
+static void revert_in_place_edits(
+  uint8_t* const var_data,
+  uint8_t* record,
+  const uint8_t* const end,
+  uint24_t offset
+);
+
+
+// Description: Relocates the gap in the edit buffer so that <offset> bytes of
+//              data are stored before it.
+// Pre:         <offset> must be less than or equal to <editor->data_size>.
+// Post:        <editor->gap_offset> == <offset>.
+static void move_gap(s_editor* const editor, const uint24_t offset);
+
+
+// Description: Copies <amount> bytes of the editor's data, starting at logical
+//              <offset>, into <dest>.
+static void read_data(
+  const s_editor* const editor,
+  const uint24_t offset,
+  uint8_t* const dest,
+  const uint24_t amount
+);
+
+
+// Description: Copies <amount> bytes from <src> into the editor's data,
+//              starting at logical <offset>.
+static void write_data(
+  s_editor* const editor,
+  const uint24_t offset,
+  const uint8_t* const src,
+  const uint24_t amount
+);
+
+
+// Description: Finds the first occurance of <phrase> that starts from <offset>
+//              to <last>. Each physically contiguous segment of the data is
+//              searched with asmutil_FindPhrase(), or asmutil_FindMaskedPhrase()
+//              if there is a <mask>, and the phrases that straddle its end are
+//              compared byte by byte.
+// Post:        If a match was found, true returned and its offset written to
+//              <match>.
+static bool find_phrase_forward(
+  const s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t offset,
+  const uint24_t last,
+  uint24_t* const match
+);
+
+
+// Description: Moves <*offset> to the first byte at or after it that can be
+//              searched, and returns the end of the bytes from there that can
+//              be searched in one piece. Only the ranges of the ports region
+//              that are safe to read are searched.
+static uint24_t search_segment(
+  const s_editor* const editor, uint24_t* const offset
+);
+
+
+static bool is_ports_editor(const s_editor* const editor);
+
+
+static bool is_ram_editor(const s_editor* const editor);
+
+
+// Description: Returns how the byte at <offset> in the ports region can be
+//              accessed.
+static uint8_t port_access(const uint24_t offset);
+
+
+// Description: Returns true if each of the <amount> bytes from <offset> can be
+//              read without side effects, or written if <write> is true. Only
+//              bytes in the ports region may not be, and nothing is written
+//              while the ports snapshot is shown.
+static bool ports_accessible(
+  const s_editor* const editor,
+  const uint24_t offset,
+  const uint24_t amount,
+  const bool write
+);
+
+
+// Description: Adds <signature> to the automaton's tree of nodes.
+// Post:        False returned if the nodes it needs do not fit, in which case
+//              the tree is unchanged.
+static bool add_signature(const uint8_t signature[], const uint8_t length);
+
+
+// Description: Links the nodes of the automaton to their <fail> and <output>
+//              nodes once every signature has been added.
+static void link_signature_nodes(void);
+
+
+// Description: Returns the automaton's node after <byte> is read in <node>.
+static uint8_t next_signature_node(uint8_t node, const uint8_t byte);
+
+
+// Description: Keeps a hit of <signature> at <offset> if there is room for it,
+//              in order of offset.
+static void add_signature_hit(const uint24_t offset, const uint8_t signature);
+
+
+// Description: Returns true if the replacement described by <header> can be
+//              made to <editor>'s data, or undone if <undo> is true. Changing
+//              the data's size needs a variable that can be resized, and RAM
+//              to unpage and grow its data. Overwriting the matches of a paged
+//              variable needs room for the <num_new_pages> pages that they
+//              touch, or else RAM to unpage its data.
+static bool can_replace(
+  const s_editor* const editor,
+  const s_replace_header* const header,
+  const uint8_t phrase_length,
+  const uint24_t num_new_pages,
+  const bool undo
+);
+
+
+// Description: Returns the number of pages that are not in the edit buffer and
+//              that the matches of the replacement undo record payload at
+//              <payload> touch. The first match is at <offset>. Only paged
+//              variables that are not edited in place load pages, and only
+//              when the matches are overwritten, so zero is returned
+//              otherwise.
+static uint24_t replace_pages(
+  const s_editor* const editor,
+  const uint8_t* const payload,
+  const uint8_t phrase_length,
+  const uint24_t offset
+);
+
+
+// Description: Returns the gap between two matches stored at <*gap>, and moves
+//              <*gap> past it.
+static uint24_t read_replace_gap(const uint8_t** const gap);
+
+
+// Description: Replaces the matches described by the replacement undo record
+//              payload at <payload>, or replaces them back if <undo> is true.
+//              The first match is at <offset>. A change in size is made in one
+//              pass over the data after the first match.
+// Post:        The cursor is on the first match.
+static void replace_matches(
+  s_editor* const editor,
+  const uint8_t* const payload,
+  const uint8_t phrase_length,
+  const uint24_t offset,
+  const bool undo
+);
+
+
+// Description: Returns true if the newest undo record can be undone.
+static bool undo_fits(const s_editor* const editor);
+
+
+// Description: Returns true if the newest redo record's change, and its undo
+//              record, fit.
+static bool redo_fits(const s_editor* const editor);
+
+
+static void addundo_write_nibble(s_editor* const editor);
+
+
+static void addundo_write_byte(s_editor* const editor);
+
+
+static void addundo_insert_bytes(
+  s_editor* const editor, const uint8_t num_bytes
+);
+
+
 static void addundo_delete_or_cut_or_paste_bytes(
   s_editor* const editor, const uint8_t code
 );
 
 
+// Description: Returns the number of bytes needed to store <delta>.
+static uint8_t delta_size(const uint24_t delta);
+
+
+static uint8_t undo_header_size(const uint8_t* const record);
+
+
+// Description: Returns the offset delta stored in <record>'s header.
+static uint24_t undo_delta(const uint8_t* const record);
+
+
+// Description: Returns the size of <record>, including its header.
+static uint24_t undo_record_size(const uint8_t* const record);
+
+
+// Description: Adds an undo record for an action at <offset> and writes its
+//              header. <payload_size> bytes are reserved after the header.
+// Post:        If there is room, pointer to the payload returned.
+//              Otherwise, NULL returned.
+static uint8_t* push_undo_record(
+  s_editor* const editor,
+  const uint8_t code,
+  const uint8_t num,
+  const uint24_t offset,
+  const uint24_t payload_size
+);
+
+
+// Description: Removes the newest undo record.
+static void pop_undo_record(void);
+
+
+// Description: Adds a byte to the newest undo record, which must be a run.
+//              Nothing is evicted to make room for it.
+// Post:        If there is room, pointer to the new byte returned.
+//              Otherwise, NULL returned.
+static uint8_t* grow_undo_run(void);
+
+
+// Description: Removes the last nibble or byte from the newest undo record,
+//              which must be a run, and drops its old value if <drop_byte> is
+//              true. A run left empty is removed.
+static void shrink_undo_run(const bool drop_byte);
+
+
+static void discard_redo_log(void);
+
+
+static uint24_t redo_payload_size(const uint8_t code, const uint8_t num);
+
+
+// Description: Adds a redo record for undoing a change at <offset>. Its
+//              payload, if any, is read from the editor's current data.
+// Post:        If the record does not fit, the whole redo log is discarded.
+static void push_redo_record(
+  const s_editor* const editor,
+  const uint8_t code,
+  const uint8_t num,
+  const uint24_t offset
+);
+
+
+// Description: Adds a redo record for undoing the replacement whose undo
+//              record, at <record>, was just popped. The redo record may
+//              overwrite the popped record.
+// Post:        If the record does not fit, the whole redo log is discarded.
+static void push_redo_replace(
+  const uint8_t* const record, const uint24_t offset
+);
+
+
+// Description: Writes the name of journal <journal> into <name>.
+static void journal_name(const uint8_t journal, char name[9]);
+
+
+// Description: Reads the footer of the open journal <handle>.
+// Post:        If the journal has a footer, true returned.
+//              Otherwise, false returned.
+static bool read_journal_footer(
+  const uint8_t handle, s_journal_footer* const footer
+);
+
+
+// Description: Returns true if an open tab keeps journal <journal>.
+static bool journal_in_use(const uint8_t journal);
+
+
+// Description: Returns the number of changes that the undo records from
+//              <record> to <end> can undo.
+static uint24_t count_undo_changes(uint8_t* record, const uint8_t* const end);
+
+
+// Description: Starts the active tab's journal for editing <editor>'s variable
+//              in place. A leftover journal for the same variable is taken
+//              over, and its undo records are loaded.
+// Pre:         The undo stack must be empty.
+// Post:        If no journal could be started, the tab keeps none.
+static void start_journal(s_editor* const editor);
+
+
+// Description: Copies the active tab's unsynced undo records into its journal
+//              if <force> is true or a batch of changes has been made.
+static void sync_journal(s_editor* const editor, const bool force);
+
+
+// Description: Marks the newest undo record as changed in the active tab's
+//              journal. Must be called before the record is changed or popped.
+static void unsync_journal_top(void);
+
+
+// Description: Ends the active tab's journal, because its in-place edits were
+//              either reverted or kept.
+static void end_journal(s_editor* const editor);
+
+
+static void spill_name(const uint8_t spill, char name[9]);
+
+
+// Description: Run-length encodes <size> bytes from <src> into <dest>.
+// Post:        The encoded size returned, or zero if encoding would not make
+//              the bytes smaller.
+static uint8_t pack_bytes(
+  const uint8_t* src, const uint8_t size, uint8_t* dest
+);
+
+
+// Description: Decodes run-length encoded bytes from <src> into <size> bytes
+//              at <dest>.
+static void unpack_bytes(const uint8_t* src, uint8_t* dest, uint8_t size);
+
+
+// Description: Adds a spilled undo record for deleting, cutting, or pasting
+//              over the selection, and moves its old bytes into the active
+//              tab's spill appvar.
+// Post:        If successful, true returned. Otherwise, no record was added.
+static bool spill_undo_record(s_editor* const editor, const uint8_t code);
+
+
+// Description: Moves the old bytes of the newest undo record, which must be
+//              spilled, from the spill appvar to <dest>.
+static void unspill_bytes(
+  s_editor* const editor, const uint8_t* const record, uint8_t* const dest
+);
+
+
+// Description: Removes <size> bytes of the oldest spilled records' old bytes
+//              from the end of the spill appvar, because they were evicted.
+static void drop_spilled_bytes(s_editor* const editor, const uint24_t size);
+
+
+// Description: Empties the active tab's spill appvar and stops using it.
+static void end_spill(s_editor* const editor);
+
+
 // =============================================================================
 // PUBLIC FUNCTION DEFINITIONS
 // =============================================================================
@@ -114,7 +862,10 @@ void tool_InitUndoStack(void)
 CCDBG_BEGINBLOCK("tool_InitUndoStack");
 CCDBG_DUMP_PTR(g_undo_stack);
 
-  g_undo_sp = g_undo_stack + (sizeof g_undo_stack) - 1;
+  g_undo_sp = g_undo_top;
+  g_undo_offset = 0;
+  discard_redo_log();
+  g_tabs[g_active_tab].journal_synced = 0;
 
 CCDBG_DUMP_PTR(g_undo_sp);
 CCDBG_ENDBLOCK();
@@ -165,10 +916,9 @@ bool tool_CreateEditBuffer(s_editor* const editor)
 {
 CCDBG_BEGINBLOCK("create_edit_buffer");
 
-  void* free = NULL;
   uint8_t handle;
-  size_t free_ram;
 
+  // Opening the appvar for writing truncates it.
   if (!(handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "w")))
   {
 CCDBG_PUTS("Cannot open edit buffer appvar.");
@@ -176,57 +926,235 @@ CCDBG_ENDBLOCK();
     return false;
   }
 
-  free_ram = os_MemChk(&free);
-  editor->buffer_size = min(MAX_VAR_DATA_SIZE, free_ram);
+  ti_Close(handle);
+  editor->base_address = tool_EditBufferPtr(&editor->buffer_size);
+
+  // Emptying the edit buffer discards every tab's region.
+  g_num_tabs = 0;
+  g_active_tab = 0;
+  g_undo_bottom = g_undo_stack;
+  g_undo_top = g_undo_stack + (sizeof g_undo_stack) - 1;
+  g_undo_sp = g_undo_top;
+  g_undo_offset = 0;
+  discard_redo_log();
+
+CCDBG_DUMP_PTR(editor->base_address);
+CCDBG_DUMP_UINT(editor->buffer_size);
+CCDBG_ENDBLOCK();
+
+  return true;
+}
+
+
+bool tool_OpenTab(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("tool_OpenTab");
+CCDBG_DUMP_UINT(g_num_tabs);
+
+  uint8_t* old_tops[G_MAX_NUM_TABS];
+  uint24_t share = (sizeof g_undo_stack) / (g_num_tabs + 1);
+  uint24_t old_share = (sizeof g_undo_stack) / (g_num_tabs ? g_num_tabs : 1);
+  uint8_t tab;
 
-  if (ti_Resize(editor->buffer_size, handle) <= 0)
+  if (g_num_tabs == G_MAX_NUM_TABS)
   {
-CCDBG_PUTS("Resize failed.");
+CCDBG_PUTS("Too many tabs.");
 CCDBG_ENDBLOCK();
     return false;
   }
 
-  ti_Close(handle);
+  if (g_num_tabs)
+    save_tab();
 
-CCDBG_DUMP_UINT(editor->buffer_size);
+  // Every open tab's undo records must still fit in its smaller share.
+  for (tab = 0; tab < g_num_tabs; tab++)
+  {
+    if (g_tabs[tab].undo_size > share)
+    {
+CCDBG_PUTS("Undo records do not fit.");
+CCDBG_ENDBLOCK();
+      return false;
+    }
+
+    old_tops[tab] = undo_top(tab);
+  }
+
+  // Redo records are dropped rather than keeping the tab from opening.
+  for (tab = 0; tab < g_num_tabs; tab++)
+  {
+    if (g_tabs[tab].undo_size + g_tabs[tab].redo_size > share)
+      g_tabs[tab].redo_size = 0;
+  }
+
+  tab = g_num_tabs++;
+  g_tabs[tab].region_size = 0;
+  g_tabs[tab].journal = NO_JOURNAL;
+  g_tabs[tab].spill = NO_SPILL;
+  g_tabs[tab].undo_size = 0;
+  g_tabs[tab].undo_offset = 0;
+  g_tabs[tab].redo_size = 0;
+  memset(g_tabs[tab].page_slots, 0, sizeof g_tabs[tab].page_slots);
+  g_tabs[tab].num_pages_loaded = 0;
+  g_tabs[tab].num_dirty_ranges = 0;
+  old_tops[tab] = undo_top(tab);
+
+  share_undo_stack(old_tops, old_share);
+  load_tab(tab);
+
+  // The newest tab's region is at the start of the edit buffer.
+  editor->base_address = tool_EditBufferPtr(&editor->buffer_size);
+  editor->buffer_size = 0;
+
+CCDBG_DUMP_UINT(g_active_tab);
 CCDBG_ENDBLOCK();
 
   return true;
 }
 
 
-void* tool_EditBufferPtr(uint24_t* size)
+void tool_CloseTab(s_editor* const editor)
 {
-  void* data = NULL;
-  uint8_t handle;
+CCDBG_BEGINBLOCK("tool_CloseTab");
+CCDBG_DUMP_UINT(g_active_tab);
 
-  if ((handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+  assert(g_num_tabs);
+
+  uint8_t* old_tops[G_MAX_NUM_TABS];
+  uint24_t old_share = (sizeof g_undo_stack) / g_num_tabs;
+  uint8_t closed_tab = g_active_tab;
+  uint8_t tab;
+
+  if (is_ports_editor(editor))
+    g_ports_snapshot_active = false;
+
+  // The tab's changes are either saved or discarded by now.
+  end_journal(editor);
+  end_spill(editor);
+
+  // The region's data is discarded, so the regions before it can be moved
+  // straight over it.
+  resize_region(editor, 0);
+
+  for (tab = closed_tab; tab < g_num_tabs - 1; tab++)
   {
-    data = ti_GetDataPtr(handle);
-    *size = ti_GetSize(handle);
-    ti_Close(handle);
+    g_tabs[tab] = g_tabs[tab + 1];
+    old_tops[tab] = undo_top(tab + 1);
   }
 
-  return data;
-}
+  for (tab = 0; tab < closed_tab; tab++)
+    old_tops[tab] = undo_top(tab);
 
+  g_num_tabs--;
+  share_undo_stack(old_tops, old_share);
 
-bool tool_CheckFreeRAM(const uint24_t amt)
-{
-  void* free = NULL;
+  if (g_num_tabs)
+    load_tab(closed_tab ? closed_tab - 1 : 0);
 
-  return (os_MemChk(free) > amt);
+CCDBG_DUMP_UINT(g_num_tabs);
+CCDBG_ENDBLOCK();
+
+  return;
 }
 
 
-int8_t tool_SaveModifiedVar(s_editor* const editor)
+void tool_SwitchTab(s_editor* const editor, const uint8_t tab)
 {
-CCDBG_BEGINBLOCK("tool_SaveModifiedVar");
+CCDBG_BEGINBLOCK("tool_SwitchTab");
+CCDBG_DUMP_UINT(tab);
 
-  s_calc_var var;
-  uint8_t var_type = editor->tios_var_type;
+  assert(tab < g_num_tabs);
 
-  if (
+  save_tab();
+  load_tab(tab);
+  update_base_address(editor);
+  update_var_data(editor);
+
+CCDBG_ENDBLOCK();
+
+  return;
+}
+
+
+uint8_t tool_NumTabs(void)
+{
+  return g_num_tabs;
+}
+
+
+uint8_t tool_ActiveTab(void)
+{
+  return g_active_tab;
+}
+
+
+void* tool_EditBufferPtr(uint24_t* size)
+{
+  void* data = NULL;
+  uint8_t handle;
+
+  if ((handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+  {
+    data = ti_GetDataPtr(handle);
+    *size = ti_GetSize(handle);
+    ti_Close(handle);
+  }
+
+  return data;
+}
+
+
+uint24_t tool_EditBufferCapacity(void)
+{
+  void* free = NULL;
+  uint24_t buffer_size = 0;
+
+  tool_EditBufferPtr(&buffer_size);
+  return min(MAX_VAR_DATA_SIZE, buffer_size + os_MemChk(&free));
+}
+
+
+uint8_t* tool_DataPtr(const s_editor* const editor, const uint24_t offset)
+{
+  uint8_t slot;
+
+  if (editor->paged)
+  {
+    if ((slot = g_page_slots[offset / EDIT_PAGE_SIZE]))
+    {
+      return (
+        editor->base_address + editor->buffer_size - (slot * EDIT_PAGE_SIZE)
+        + (offset % EDIT_PAGE_SIZE)
+      );
+    }
+
+    return editor->var_data + offset;
+  }
+
+  if (offset < editor->gap_offset)
+    return editor->base_address + offset;
+
+  return (
+    editor->base_address + editor->buffer_size - editor->data_size + offset
+  );
+}
+
+
+bool tool_CheckFreeRAM(const uint24_t amt)
+{
+  void* free = NULL;
+
+  return (os_MemChk(free) > amt);
+}
+
+
+int8_t tool_SaveModifiedVar(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("tool_SaveModifiedVar");
+
+  s_calc_var var;
+  uint8_t var_type = editor->tios_var_type;
+
+  if (
     !hevat_GetVarInfoByNameAndType(
       &var, editor->name, editor->name_length, editor->tios_var_type
     )
@@ -238,6 +1166,36 @@ CCDBG_ENDBLOCK();
     return 0;
   }
 
+  if (editor->in_place)
+  {
+CCDBG_PUTS("Variable was edited in place");
+CCDBG_ENDBLOCK();
+
+    return 1;
+  }
+
+  if (editor->paged)
+  {
+CCDBG_ENDBLOCK();
+
+    return save_paged_var(editor, &var);
+  }
+
+  // If the data is the same size as the variable, only the modified bytes
+  // need to be written back.
+  if (editor->data_size == (uint24_t)(var.size - (var.named ? 2 : 0)))
+  {
+    if (patch_var(editor, &var))
+    {
+CCDBG_PUTS("Patched variable");
+CCDBG_ENDBLOCK();
+
+      return 1;
+    }
+
+CCDBG_PUTS("Could not patch variable");
+  }
+
   if (
     var_type == OS_TYPE_PRGM
     || var_type == OS_TYPE_PROT_PRGM
@@ -246,33 +1204,12 @@ CCDBG_ENDBLOCK();
   {
 CCDBG_PUTS("Saving variable that can be resized");
 
-    if (shrink_edit_buffer(editor))
+    if (!stream_var(editor, &var))
     {
-CCDBG_DUMP_UINT(tool_CheckFreeRAM(editor->data_size));
-
-      if (!tool_CheckFreeRAM(editor->data_size))
-      {
-        if (!archive_edit_buffer())
-          return 0;
-      }
-
-      if (!save_edited_var(&var))
-      {
 CCDBG_PUTS("Variable not saved");
-        return 0;
-      }
-
-      tool_DeleteEditBuffer();
+CCDBG_ENDBLOCK();
 
-      if (!tool_CreateEditBuffer(editor))
-      {
-CCDBG_PUTS("FATAL: Could not create edit buffer");
-        return -1;
-      }
-    }
-    else
-    {
-CCDBG_PUTS("Edit buffer not shrunk");
+      return 0;
     }
   }
   else
@@ -289,55 +1226,70 @@ CCDBG_ENDBLOCK();
 }
 
 
-bool tool_BufferVarData(
+uint24_t tool_SaveRAMShortfall(const s_editor* const editor)
+{
+  s_calc_var var;
+  void* free = NULL;
+  uint24_t available;
+
+  if (
+    !editor->is_tios_var
+    || !editor->paged
+    || editor->in_place
+    || !hevat_GetVarInfoByNameAndType(
+      &var, editor->name, editor->name_length, editor->tios_var_type
+    )
+    || !var.archived
+  )
+    return 0;
+
+  available = (
+    os_MemChk(free) + editor->buffer_size
+    - (g_num_pages_loaded * EDIT_PAGE_SIZE)
+  );
+
+  // tool_CheckFreeRAM() needs more free RAM than the amount asked for.
+  return (var.size < available ? 0 : var.size + 1 - available);
+}
+
+
+bool tool_PageVarData(
   s_editor* const editor,
   void* data,
   const uint24_t size,
-  const uint24_t offset
+  const uint24_t offset,
+  const bool in_place
 )
 {
-CCDBG_BEGINBLOCK("tool_BufferVarData");
-CCDBG_DUMP_PTR(editor->base_address);
-CCDBG_DUMP_UINT(editor->buffer_size);
+CCDBG_BEGINBLOCK("tool_PageVarData");
 
-  assert(editor->base_address);
-  assert(editor->buffer_size);
+  g_num_page_slots = min(editor->buffer_size / EDIT_PAGE_SIZE, UINT8_MAX);
 
-  editor->data_size = size;
-
-CCDBG_DUMP_UINT(editor->data_size);
+CCDBG_DUMP_PTR(editor->base_address);
+CCDBG_DUMP_UINT(g_num_page_slots);
+CCDBG_DUMP_UINT(in_place);
 
-  if (size > editor->buffer_size)
+  if (!editor->base_address)
   {
-CCDBG_PUTS("Buffer size too small for variable.");
+CCDBG_PUTS("No edit buffer.");
 CCDBG_ENDBLOCK();
     return false;
   }
 
-  if (!size)
-    editor->near_size = 0;
-  else if (editor->selection_size)
-    editor->near_size = offset + editor->selection_size;
-  else
-    editor->near_size = offset + 1;
+  memset(g_page_slots, 0, sizeof g_page_slots);
+  g_num_pages_loaded = 0;
+  g_num_dirty_ranges = 0;
 
-  assert(editor->near_size <= size);
-
-  editor->far_size = size - editor->near_size;
+  editor->data_size = size;
+  editor->paged = true;
+  editor->in_place = in_place;
+  editor->var_data = data;
+  editor->gap_offset = size;
+  set_cursor(editor, offset);
 
-CCDBG_DUMP_UINT(editor->near_size);
-CCDBG_DUMP_UINT(editor->far_size);
-CCDBG_PUTS("About to copy data");
-
-  asmutil_CopyData(data, editor->base_address, editor->near_size, 1);
-  asmutil_CopyData(
-    data + size - 1,
-    editor->base_address + editor->buffer_size - 1,
-    editor->far_size,
-    0
-  );
+  if (in_place)
+    start_journal(editor);
 
-CCDBG_DUMP_UINT(editor->data_size);
 CCDBG_ENDBLOCK();
   return true;
 }
@@ -345,14 +1297,7 @@ CCDBG_ENDBLOCK();
 
 void tool_LoadEditBufferIntoVar(s_editor* const editor, uint8_t* const var_data)
 {
-  asmutil_CopyData(editor->base_address, var_data, editor->near_size, 1);
-  asmutil_CopyData(
-    editor->base_address + editor->buffer_size - editor->far_size,
-    var_data + editor->near_size,
-    editor->far_size,
-    1
-  );
-
+  read_data(editor, 0, var_data, editor->data_size);
   return;
 }
 
@@ -366,18 +1311,130 @@ void tool_DeleteEditBuffer(void)
 #endif
 
   int deleted; (void)deleted;
+  char name[9];
 
   deleted = ti_Delete(G_EDIT_BUFFER_APPVAR_NAME);
 
   // If this assert() fires, the delete failed.
   assert(deleted != 0);
+
+  // The spill appvars only hold undo records for the edit buffer's data.
+  for (uint8_t spill = 0; spill < G_MAX_NUM_TABS; spill++)
+  {
+    spill_name(spill, name);
+    ti_Delete(name);
+  }
+
+  return;
+}
+
+
+void tool_SyncJournal(s_editor* const editor)
+{
+  sync_journal(editor, true);
+  return;
+}
+
+
+bool tool_GetJournalVar(const uint8_t journal, void** const vatptr)
+{
+  s_journal_footer footer;
+  s_calc_var var;
+  char name[9];
+  uint8_t handle;
+  bool found = false;
+
+  journal_name(journal, name);
+
+  if (!(handle = ti_Open(name, "r")))
+    return false;
+
+  // The variable must still be in RAM and the same size for the journal's
+  // offsets to be valid.
+  if (
+    read_journal_footer(handle, &footer)
+    && hevat_GetVarInfoByNameAndType(
+      &var, footer.name, footer.name_length, footer.var_type
+    )
+    && !var.archived
+    && (uint24_t)(var.size - (var.named ? 2 : 0)) == footer.var_size
+  )
+  {
+    *vatptr = var.vatptr;
+    found = true;
+  }
+
+  ti_Close(handle);
+
+  if (!found)
+    ti_Delete(name);
+
+  return found;
+}
+
+
+void tool_RollBackJournal(const uint8_t journal)
+{
+CCDBG_BEGINBLOCK("tool_RollBackJournal");
+
+  s_journal_footer footer;
+  s_calc_var var;
+  char name[9];
+  uint8_t handle;
+  uint8_t* records;
+
+  journal_name(journal, name);
+  handle = ti_Open(name, "r");
+
+  if (
+    handle
+    && read_journal_footer(handle, &footer)
+    && hevat_GetVarInfoByNameAndType(
+      &var, footer.name, footer.name_length, footer.var_type
+    )
+  )
+  {
+    records = ti_GetDataPtr(handle);
+    revert_in_place_edits(
+      var.data + (var.named ? 2 : 0),
+      records,
+      records + ti_GetSize(handle) - sizeof footer,
+      footer.undo_offset
+    );
+  }
+
+  if (handle)
+    ti_Close(handle);
+
+  ti_Delete(name);
+
+CCDBG_ENDBLOCK();
+  return;
+}
+
+
+void tool_DeleteJournal(const uint8_t journal)
+{
+  char name[9];
+
+  journal_name(journal, name);
+  ti_Delete(name);
+  return;
+}
+
+
+void tool_DeleteJournals(void)
+{
+  for (uint8_t journal = 0; journal < G_MAX_NUM_TABS; journal++)
+    tool_DeleteJournal(journal);
+
   return;
 }
 
 
 bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
 {
-  const uint8_t NUM_TOOLS = 11;
+  const uint8_t NUM_TOOLS = 15;
 
   void* tools[] = {
     &tool_WriteNibble,
@@ -388,9 +1445,13 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
     &tool_CopyBytes,
     &tool_CutBytes,
     &tool_PasteBytes,
-    &tool_FindPhrase,
+    &tool_FindNextPhrase,
     &tool_SwitchWritingMode,
-    &tool_UndoLastAction
+    &tool_UndoLastAction,
+    &tool_RedoLastAction,
+    &tool_ReplacePhrase,
+    &tool_FindSignatures,
+    &tool_TakePortsSnapshot
   };
   bool available = false;
   uint8_t idx;
@@ -410,6 +1471,10 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         !editor->selection_active
         && editor->near_size
         && editor->writing_mode == 'x'
+        && pages_writable(editor, editor->near_size - 1, 1)
+        && ports_accessible(editor, editor->near_size - 1, 1, false)
+        && ports_accessible(editor, editor->near_size - 1, 1, true)
+        && undo_record_fits(editor)
       )
       {
         available = true;
@@ -421,6 +1486,9 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         !editor->selection_active
         && editor->near_size
         && editor->writing_mode != 'x'
+        && pages_writable(editor, editor->near_size - 1, 1)
+        && ports_accessible(editor, editor->near_size - 1, 1, true)
+        && undo_record_fits(editor)
       )
       {
         available = true;
@@ -437,6 +1505,8 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         editor->is_tios_var
         && editor->access_type == 'i'
         && !editor->selection_active
+        && can_unpage(editor)
+        && undo_record_fits(editor)
       )
       {
         available = true;
@@ -445,7 +1515,11 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
 
     case 4: // tool_DeleteBytes
       if (
-        editor->is_tios_var && editor->access_type == 'i' && editor->near_size
+        editor->is_tios_var
+        && editor->access_type == 'i'
+        && editor->near_size
+        && can_unpage(editor)
+        && undo_record_fits(editor)
       )
       {
         available = true;
@@ -457,6 +1531,12 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         editor->selection_active
         && editor->selection_size
         && editor->near_size >= editor->selection_size
+        && ports_accessible(
+          editor,
+          editor->near_size - editor->selection_size,
+          editor->selection_size,
+          false
+        )
       )
       {
         available = true;
@@ -470,6 +1550,8 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         && editor->selection_active
         && editor->selection_size
         && editor->near_size >= editor->selection_size
+        && can_unpage(editor)
+        && undo_record_fits(editor)
       )
       {
         available = true;
@@ -481,13 +1563,26 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         (editor->access_type == 'w' || editor->access_type == 'i')
         && g_cutcopy_buffer_size
         && (editor->selection_size == g_cutcopy_buffer_size)
+        && pages_writable(
+          editor,
+          editor->near_size - editor->selection_size,
+          editor->selection_size
+        )
+        && ports_accessible(
+          editor,
+          editor->near_size - editor->selection_size,
+          editor->selection_size,
+          true
+        )
+        && undo_record_fits(editor)
       )
       {
         available = true;
       }
       break;
 
-    case 8: // tool_FindPhrase
+    case 8:  // tool_FindNextPhrase
+    case 13: // tool_FindSignatures
       if (
         !editor->selection_active && editor->data_size >= G_NUM_BYTES_ONSCREEN
       )
@@ -506,12 +1601,46 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr)
         !editor->selection_active
         && editor->undo_buffer_active
         && editor->num_changes
+        && !tool_PortsSnapshotActive(editor)
+        && undo_fits(editor)
+      )
+      {
+        available = true;
+      }
+      break;
+
+    case 11: // tool_RedoLastAction
+      if (
+        !editor->selection_active
+        && editor->undo_buffer_active
+        && g_redo_sp > g_undo_bottom
+        && !tool_PortsSnapshotActive(editor)
+        && redo_fits(editor)
       )
       {
         available = true;
       }
       break;
 
+    case 12: // tool_ReplacePhrase
+      // Whether the replacement itself fits is only known once its matches
+      // are found. RAM holds the undo stack, so pushing the replacement's undo
+      // record could change the matches that were counted.
+      if (
+        (editor->access_type == 'w' || editor->access_type == 'i')
+        && !is_ram_editor(editor)
+        && !tool_PortsSnapshotActive(editor)
+      )
+      {
+        available = true;
+      }
+      break;
+
+    case 14: // tool_TakePortsSnapshot
+      if (is_ports_editor(editor) && !editor->selection_active)
+        available = true;
+      break;
+
     default:
       break;
   }
@@ -525,8 +1654,6 @@ void tool_MoveCursor(
 )
 {
   uint24_t copy_size = amt;
-  uint24_t copy_src_offset = 0;
-  uint24_t copy_dest_offset = 0;
 
   if (direction == 0)
   {
@@ -539,8 +1666,6 @@ void tool_MoveCursor(
 
     editor->near_size -= copy_size;
     editor->far_size += copy_size;
-    copy_src_offset = editor->near_size;
-    copy_dest_offset = editor->buffer_size - editor->far_size;
 
     if (editor->selection_active)
       editor->selection_size -= min(editor->selection_size, copy_size);
@@ -559,18 +1684,6 @@ void tool_MoveCursor(
 
     editor->near_size += copy_size;
     editor->far_size -= copy_size;
-    copy_src_offset = editor->buffer_size - editor->far_size - copy_size;
-    copy_dest_offset = editor->near_size - copy_size;
-  }
-
-  if (editor->is_tios_var)
-  {
-    asmutil_CopyData(
-      editor->base_address + copy_src_offset,
-      editor->base_address + copy_dest_offset,
-      copy_size,
-      1
-    );
   }
 
   // Any time the cursor is moved, reset the nibble selector to the high nibble.
@@ -610,7 +1723,13 @@ void tool_WriteNibble(s_editor* const editor, uint8_t nibble)
   assert(!editor->selection_active);
   assert(editor->writing_mode == 'x');
 
-  uint8_t* address = editor->base_address + editor->near_size - 1;
+  uint8_t* address;
+
+  // Overwriting a byte does not change the data's size, so the gap can stay
+  // where it is.
+  load_pages(editor, editor->near_size - 1, 1);
+  mark_dirty(editor->near_size - 1, editor->near_size);
+  address = tool_DataPtr(editor, editor->near_size - 1);
 
 	if (editor->high_nibble)
 	{
@@ -631,8 +1750,9 @@ void tool_WriteByte(s_editor* const editor, uint8_t byte)
   assert(!editor->selection_active);
   assert(editor->writing_mode != 'x');
 
-  uint8_t* address = editor->base_address + editor->near_size - 1;
-  *address = byte;
+  load_pages(editor, editor->near_size - 1, 1);
+  mark_dirty(editor->near_size - 1, editor->near_size);
+  *tool_DataPtr(editor, editor->near_size - 1) = byte;
   return;
 }
 
@@ -675,42 +1795,61 @@ CCDBG_ENDBLOCK();
 }
 
 
+bool tool_CanInsertBytes(const s_editor* const editor, const uint24_t num)
+{
+  // A paged variable is unpaged first, and the bytes may need more room than
+  // the page slots that unpaging it frees.
+  return (
+    can_unpage(editor)
+    && can_grow_edit_buffer(editor, editor->data_size + num)
+  );
+}
+
+
 void tool_InsertBytes(s_editor* const editor, const uint24_t num)
 {
   assert(editor->is_tios_var);
   assert(editor->access_type == 'i');
   assert(!editor->selection_active);
 
-  uint24_t bytes_inserted = min(editor->buffer_size - editor->data_size, num);
+  uint24_t bytes_inserted = num;
+  uint24_t insert_offset = editor->near_size - (editor->near_size ? 1 : 0);
+
+  // The undo record for the insertion is already pushed, so either all of the
+  // bytes are inserted or none are.
+  if (!tool_CanInsertBytes(editor, num))
+    return;
+
+  unpage_data(editor);
+
+  if (
+    !num
+    || (
+      editor->buffer_size - editor->data_size < num
+      && !grow_edit_buffer(editor, editor->data_size + num)
+    )
+  )
+    return;
 
+  // The new bytes are inserted before the byte at the cursor by writing them
+  // into the start of the gap.
+  move_gap(editor, insert_offset);
+  memset(editor->base_address + insert_offset, 0x00, bytes_inserted);
+  editor->gap_offset += bytes_inserted;
   editor->data_size += bytes_inserted;
 
+  // Every byte after the insertion point has moved.
+  mark_dirty(insert_offset, editor->data_size);
+
   // Empty variable.
   if (!editor->near_size)
   {
     editor->near_size = 1;
-  }
-  else
-  {
-    // Copy the byte at the cursor to the far buffer.
-    editor->far_size++;
-    *(editor->base_address + editor->buffer_size - editor->far_size) = *(
-      editor->base_address + editor->near_size - 1
-    );
+    bytes_inserted--;
   }
 
-  // The near buffer always consumes one of the inserted bytes.
-  bytes_inserted--;
+  // The cursor stays on the first inserted byte.
   editor->far_size += bytes_inserted;
-
-  // Set the inserted bytes to 0x00.
-  *(editor->base_address + editor->near_size - 1) = 0x00;
-  memset(
-    editor->base_address + editor->buffer_size - editor->far_size,
-    0x00,
-    bytes_inserted
-  );
-
   return;
 }
 
@@ -723,22 +1862,25 @@ CCDBG_BEGINBLOCK("tool_DeleteBytes");
   assert(editor->access_type == 'i');
   assert(editor->near_size);
 
-  editor->data_size -= editor->selection_size;
-
 CCDBG_DUMP_UINT(editor->selection_size);
 
   // Algorithm:
+  //   - Move the gap to the end of the selection and grow it backwards over
+  //     the selected bytes.
   //   - Reduce the near buffer's size by <selection_size>
-  //   - If the far buffer has bytes, move its first byte to the end of the near
-  //     buffer.
+  //   - If the far buffer has bytes, move the cursor onto its first byte.
 
+  unpage_data(editor);
+  move_gap(editor, editor->near_size);
+  editor->gap_offset -= editor->selection_size;
+  editor->data_size -= editor->selection_size;
   editor->near_size -= editor->selection_size;
 
+  // Every byte after the deleted bytes has moved.
+  mark_dirty(editor->gap_offset, editor->data_size);
+
   if (editor->far_size)
   {
-    *(editor->base_address + editor->near_size) = *(
-      editor->base_address + editor->buffer_size - editor->far_size
-    );
     editor->near_size++;
     editor->far_size--;
   }
@@ -761,11 +1903,11 @@ void tool_CopyBytes(const s_editor* const editor)
   assert(editor->selection_size);
   assert(editor->near_size >= editor->selection_size);
 
-  asmutil_CopyData(
-    editor->base_address + editor->near_size - editor->selection_size,
+  read_data(
+    editor,
+    editor->near_size - editor->selection_size,
     g_cutcopy_buffer,
-    editor->selection_size,
-    1
+    editor->selection_size
   );
 
   g_cutcopy_buffer_size = editor->selection_size;
@@ -793,121 +1935,461 @@ void tool_PasteBytes(s_editor* const editor)
   assert(g_cutcopy_buffer_size);
   assert(editor->selection_size == g_cutcopy_buffer_size);
 
-  asmutil_CopyData(
+  write_data(
+    editor,
+    editor->near_size - editor->selection_size,
     g_cutcopy_buffer,
-    editor->base_address + editor->near_size - editor->selection_size,
-    g_cutcopy_buffer_size,
-    1
+    g_cutcopy_buffer_size
   );
 
   return;
 }
 
 
-void tool_FindPhrase(
-  s_editor* const editor,
+bool tool_FindNextPhrase(
+  const s_editor* const editor,
   const uint8_t phrase[],
+  const uint8_t mask[],
   const uint8_t length,
-  uint24_t matches[],
-  uint8_t* const num_matches
+  uint24_t offset,
+  const bool forward,
+  uint24_t* const match
 )
 {
-CCDBG_BEGINBLOCK("tool_FindPhrase");
-CCDBG_DUMP_UINT(editor->near_size);
+CCDBG_BEGINBLOCK("tool_FindNextPhrase");
+CCDBG_DUMP_UINT(offset);
+CCDBG_DUMP_UINT(forward);
 
-  assert(!editor->selection_active);
-  assert(editor->data_size > G_NUM_BYTES_ONSCREEN);
-  assert(length < editor->data_size);
-  assert(*num_matches == 0);
   assert(length > 1);
 
-  const uint8_t MAX_NUM_MATCHES = 255;
+  uint24_t last_start;
+  uint24_t chunk_start;
+  bool found = false;
 
-  uint8_t num_matches_near_buffer = 0;
-  uint8_t num_matches_far_buffer = 0;
-  uint8_t* far_start_address;
+  if (editor->data_size < length)
+  {
+CCDBG_ENDBLOCK();
+    return false;
+  }
 
-  // If the very last byte of the near buffer is the start of the phrase, we
-  // need add <length> - 1 bytes from the start of the far buffer to the end of
-  // the near buffer to catch that phrase occurrance.
-  tool_MoveCursor(editor, 1, length - 1);
+  last_start = editor->data_size - length;
 
-  if (
-    !memcmp(editor->base_address + editor->near_size - length, phrase, length)
-  )
+  if (forward)
   {
-    // Add the base address because the first convert for-loop expects it.
-    matches[0] = (uint24_t)editor->base_address + editor->near_size - length;
-    num_matches_far_buffer = 1;
+    found = (
+      offset <= last_start
+      && find_phrase_forward(
+        editor, phrase, mask, length, offset, last_start, match
+      )
+    );
+
+CCDBG_DUMP_UINT(*match);
+CCDBG_ENDBLOCK();
+    return found;
   }
 
-  // Move the cursor back to its original position.
-  tool_MoveCursor(editor, 0, length - 1);
+  // The data is searched backward one chunk at a time, and the last match in
+  // each chunk is found by searching it forward.
+  offset = min(offset, last_start);
 
-  CCDBG_DUMP_UINT(editor->near_size);
+  while (!found)
+  {
+    chunk_start = (
+      offset >= FIND_CHUNK_SIZE ? offset - FIND_CHUNK_SIZE + 1 : 0
+    );
 
-  far_start_address = (
-    editor->base_address + editor->buffer_size - editor->far_size
-  );
+    while (
+      find_phrase_forward(
+        editor, phrase, mask, length, chunk_start, offset, match
+      )
+    )
+    {
+      found = true;
+      chunk_start = *match + 1;
+    }
+
+    if (found || chunk_start == 0)
+      break;
+
+    offset = chunk_start - 1;
+  }
+
+CCDBG_DUMP_UINT(*match);
+CCDBG_ENDBLOCK();
+  return found;
+}
+
+
+bool tool_FindPhraseInRange(
+  const s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  const uint24_t offset,
+  const uint24_t last,
+  uint24_t* const match
+)
+{
+  assert(length > 1);
 
-  num_matches_far_buffer += asmutil_FindPhrase(
-    far_start_address,
-    editor->base_address + editor->buffer_size - 1,
+  if (editor->data_size < length || offset > last)
+    return false;
+
+  return find_phrase_forward(
+    editor,
     phrase,
+    mask,
     length,
-    matches + num_matches_far_buffer,
-    MAX_NUM_MATCHES
+    offset,
+    min(last, editor->data_size - length),
+    match
   );
+}
+
+
+uint24_t tool_ReplacePhrase(
+  s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t length,
+  const uint8_t replacement[],
+  const uint8_t replacement_length,
+  uint24_t offset,
+  uint24_t last
+)
+{
+CCDBG_BEGINBLOCK("tool_ReplacePhrase");
+CCDBG_DUMP_UINT(offset);
+CCDBG_DUMP_UINT(last);
+
+  assert(!editor->selection_active);
+  assert(length > 1);
+  assert(replacement_length);
+
+  s_replace_header header = {
+    .gaps_size = 0, .num_matches = 0, .replacement_length = replacement_length
+  };
+  uint24_t first_match = 0;
+  uint24_t match;
+  uint24_t end = 0;
+  uint24_t next_page = 0;
+  uint24_t num_new_pages = 0;
+  uint8_t* payload;
+  uint8_t* gap;
+
+  if (editor->data_size < length)
+  {
+CCDBG_ENDBLOCK();
+    return 0;
+  }
+
+  last = min(last, editor->data_size - length);
 
-  // Convert the physical memory addresses into offsets relative to the edit
-  // buffer's base address.
-  for (uint8_t idx = 0; idx < num_matches_far_buffer; idx++)
+  // The matches are counted first, so that nothing is changed unless the
+  // replacement and its undo record fit. Matches do not overlap.
+  while (
+    offset <= last
+    && find_phrase_forward(editor, phrase, NULL, length, offset, last, &match)
+  )
   {
-    matches[idx] -= (uint24_t)far_start_address + editor->near_size - 2;
+    if (header.num_matches++)
+    {
+      header.gaps_size += (
+        match - end < REPLACE_LONG_GAP ? 1 : 1 + sizeof(uint24_t)
+      );
+    }
+    else
+      first_match = match;
+
+    count_new_pages(match, length, &next_page, &num_new_pages);
+    offset = end = match + length;
   }
 
-  num_matches_near_buffer = asmutil_FindPhrase(
-    editor->base_address,
-    editor->base_address + editor->near_size - 1,
-    phrase,
+CCDBG_DUMP_UINT(header.num_matches);
+
+  if (
+    !header.num_matches
+    || !can_replace(editor, &header, length, num_new_pages, false)
+  )
+  {
+CCDBG_ENDBLOCK();
+    return 0;
+  }
+
+  discard_redo_log();
+  payload = push_undo_record(
+    editor,
+    UNDO_REPLACE_BYTES,
     length,
-    matches + num_matches_far_buffer,
-    MAX_NUM_MATCHES - num_matches_far_buffer
+    first_match,
+    sizeof header + length + replacement_length + header.gaps_size
   );
 
-  // Convert the physical memory addresses into offsets relative to the edit
-  // buffer's base address.
-  for (
-    uint8_t idx = num_matches_far_buffer;
-    idx < num_matches_near_buffer + num_matches_far_buffer;
-    idx++
-  )
+  if (!payload)
   {
-    matches[idx] -= (uint24_t)editor->base_address;
+CCDBG_ENDBLOCK();
+    return 0;
   }
 
-  *num_matches = num_matches_near_buffer + num_matches_far_buffer;
+  memcpy(payload, &header, sizeof header);
+  memcpy(payload + sizeof header, phrase, length);
+  memcpy(payload + sizeof header + length, replacement, replacement_length);
+  gap = payload + sizeof header + length + replacement_length;
+  end = first_match + length;
+
+  for (uint24_t idx = 1; idx < header.num_matches; idx++)
+  {
+    find_phrase_forward(editor, phrase, NULL, length, end, last, &match);
+
+    if (match - end < REPLACE_LONG_GAP)
+      *gap++ = match - end;
+    else
+    {
+      *gap++ = REPLACE_LONG_GAP;
+      *(uint24_t*)gap = match - end;
+      gap += sizeof(uint24_t);
+    }
+
+    end = match + length;
+  }
+
+  editor->num_changes++;
+
+  // A replacement can change a lot of data at once, so the journal is brought
+  // up to date before the replacement is made.
+  sync_journal(editor, true);
+  replace_matches(editor, payload, length, first_match, false);
+
+CCDBG_ENDBLOCK();
+  return header.num_matches;
+}
 
-#if USE_CCDBG
-CCDBG_DUMP_UINT(*num_matches);
-CCDBG_DUMP_UINT(num_matches_far_buffer);
-CCDBG_DUMP_UINT(num_matches_near_buffer);
-CCDBG_DUMP_PTR(editor->base_address);
-CCDBG_DUMP_UINT(editor->near_size);
-CCDBG_DUMP_PTR(editor->base_address + editor->near_size - 1);
 
-for (uint8_t idx = 0; idx < *num_matches; idx++)
+uint8_t tool_LoadSignatures(void)
 {
-  CCDBG_DUMP_UINT(matches[idx]);
+  uint8_t num_signatures = 0;
+  uint8_t handle;
+
+  if ((handle = ti_Open(G_SIGNATURES_APPVAR_NAME, "r")))
+  {
+    num_signatures = tool_SetSignatures(
+      ti_GetDataPtr(handle), ti_GetSize(handle)
+    );
+    ti_Close(handle);
+  }
+  else
+    tool_SetSignatures(NULL, 0);
+
+  return num_signatures;
 }
-#endif
 
+
+uint8_t tool_SetSignatures(const uint8_t data[], const uint24_t size)
+{
+CCDBG_BEGINBLOCK("tool_SetSignatures");
+
+  uint24_t idx = 0;
+  uint8_t length;
+
+  memset(&g_signature_nodes[0], 0, sizeof(s_signature_node));
+  g_num_signature_nodes = 1;
+  g_num_signatures = 0;
+
+  // Each signature is its length followed by its bytes. The signatures stop at
+  // a length of zero, at one that is too long, or when the automaton is full.
+  while (idx < size && g_num_signatures < MAX_NUM_SIGNATURES)
+  {
+    length = data[idx];
+
+    if (
+      !length
+      || length > MAX_SIGNATURE_LENGTH
+      || length > size - idx - 1
+      || !add_signature(data + idx + 1, length)
+    )
+    {
+      break;
+    }
+
+    g_signature_lengths[g_num_signatures++] = length;
+    idx += length + 1;
+  }
+
+  link_signature_nodes();
+
+CCDBG_DUMP_UINT(g_num_signatures);
+CCDBG_DUMP_UINT(g_num_signature_nodes);
+CCDBG_ENDBLOCK();
+  return g_num_signatures;
+}
+
+
+uint24_t tool_FindSignatures(const s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("tool_FindSignatures");
+
+  const uint8_t* data;
+  uint24_t num_hits = 0;
+  uint24_t offset = 0;
+  uint24_t start;
+  uint24_t end;
+  uint8_t node = 0;
+  uint8_t output;
+
+  g_num_signature_hits = 0;
+
+  // The automaton's node carries over from one segment of the data to the
+  // next, so every byte is read once.
+  while (offset < editor->data_size)
+  {
+    start = offset;
+    end = search_segment(editor, &offset);
+    data = tool_DataPtr(editor, offset);
+
+    // A hit cannot span the bytes that were skipped.
+    if (offset != start)
+      node = 0;
+
+    for (; offset < end; offset++)
+    {
+      if (node)
+        node = next_signature_node(node, *data++);
+      else
+        node = g_signature_root[*data++];
+
+      if (!node)
+        continue;
+
+      if (g_signature_nodes[node].signature)
+        output = node;
+      else
+        output = g_signature_nodes[node].output;
+
+      while (output)
+      {
+        add_signature_hit(
+          offset + 1
+          - g_signature_lengths[g_signature_nodes[output].signature - 1],
+          g_signature_nodes[output].signature
+        );
+        num_hits++;
+        output = g_signature_nodes[output].output;
+      }
+    }
+  }
+
+CCDBG_DUMP_UINT(num_hits);
+CCDBG_ENDBLOCK();
+  return num_hits;
+}
+
+
+uint8_t tool_NumSignatureHits(void)
+{
+  return g_num_signature_hits;
+}
+
+
+uint24_t tool_SignatureHit(
+  const uint8_t hit, uint8_t* const signature, uint8_t* const length
+)
+{
+  *signature = g_signature_hits[hit].signature;
+  *length = g_signature_lengths[*signature - 1];
+  return g_signature_hits[hit].offset;
+}
+
+
+uint8_t tool_PortAccess(const s_editor* const editor, const uint24_t offset)
+{
+  if (!is_ports_editor(editor))
+    return PORT_READ_SAFE;
+
+  return port_access(offset);
+}
+
+
+bool tool_ViewByte(
+  const s_editor* const editor, const uint24_t offset, uint8_t* const value
+)
+{
+  uint8_t access;
+
+  if (!is_ports_editor(editor))
+  {
+    *value = *tool_DataPtr(editor, offset);
+    return true;
+  }
+
+  access = port_access(offset);
+
+  if (access != PORT_READ_SAFE && access != PORT_READ_SIDE_EFFECTS)
+    return false;
+
+  if (
+    g_ports_snapshot_active
+    && offset >= g_ports_snapshot_offset
+    && offset - g_ports_snapshot_offset < g_ports_snapshot_size
+  )
+  {
+    *value = g_ports_snapshot[offset - g_ports_snapshot_offset];
+    return true;
+  }
+
+  if (access != PORT_READ_SAFE)
+    return false;
+
+  *value = *tool_DataPtr(editor, offset);
+  return true;
+}
+
+
+void tool_TakePortsSnapshot(const s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("tool_TakePortsSnapshot");
+
+  uint24_t offset = editor->window_offset;
+  uint8_t access;
+
+  assert(is_ports_editor(editor));
+
+  g_ports_snapshot_offset = offset;
+  g_ports_snapshot_size = min(
+    G_NUM_BYTES_ONSCREEN, editor->data_size - editor->window_offset
+  );
+
+  // Each port that can be read is read once, including those with side
+  // effects, since the snapshot was asked for.
+  for (uint8_t idx = 0; idx < g_ports_snapshot_size; idx++)
+  {
+    access = port_access(offset);
+
+    if (access == PORT_READ_SAFE || access == PORT_READ_SIDE_EFFECTS)
+      g_ports_snapshot[idx] = *tool_DataPtr(editor, offset);
+
+    offset++;
+  }
+
+  g_ports_snapshot_active = true;
+
+CCDBG_DUMP_UINT(g_ports_snapshot_offset);
 CCDBG_ENDBLOCK();
+  return;
+}
+
 
+void tool_EndPortsSnapshot(void)
+{
+  g_ports_snapshot_active = false;
   return;
 }
 
 
+bool tool_PortsSnapshotActive(const s_editor* const editor)
+{
+  return is_ports_editor(editor) && g_ports_snapshot_active;
+}
+
+
 void tool_SwitchWritingMode(s_editor* const editor)
 {
   assert(!editor->selection_active);
@@ -939,56 +2421,95 @@ CCDBG_DUMP_PTR(g_undo_sp);
   assert(editor->undo_buffer_active);
   assert(editor->num_changes);
 
-  uint8_t num_bytes;
-  uint8_t code = *(++g_undo_sp);
+  uint8_t* record = g_undo_sp + 1;
+  uint8_t code = record[0];
+  uint8_t num = record[1];
+  uint8_t* payload = record + undo_header_size(record);
+  uint24_t offset = g_undo_offset;
+  uint24_t nibble;
+  uint8_t byte;
 
-  g_undo_sp++;
 CCDBG_DUMP_UINT(code);
+CCDBG_DUMP_UINT(offset);
 
   switch (code)
   {
-    case UNDO_WRITE_NIBBLE:
-      tool_Goto(editor, *(uint24_t*)g_undo_sp);
-
-CCDBG_DUMP_UINT(*(uint24_t*)g_undo_sp);
-
-      g_undo_sp += sizeof(uint24_t);
-
-      if (*g_undo_sp++)
-        editor->high_nibble = true;
+    case UNDO_WRITE_HIGH_NIBBLES:
+    case UNDO_WRITE_LOW_NIBBLES:
+      // Only the last nibble of the run is undone.
+      nibble = 2 * offset + (code == UNDO_WRITE_LOW_NIBBLES) + num - 1;
+      tool_Goto(editor, nibble / 2);
+      editor->high_nibble = !(nibble % 2);
+      byte = *tool_DataPtr(editor, nibble / 2);
+
+      if (editor->high_nibble)
+        byte = (byte & 0x0f) | (*payload & 0xf0);
       else
-        editor->high_nibble = false;
-
-      tool_WriteNibble(editor, *g_undo_sp);
+        byte = (byte & 0xf0) | (*payload & 0x0f);
+
+      // A byte's old value is only needed until its first nibble in the run
+      // is undone.
+      shrink_undo_run(editor->high_nibble);
+      push_redo_record(
+        editor,
+        editor->high_nibble ? UNDO_WRITE_HIGH_NIBBLES : UNDO_WRITE_LOW_NIBBLES,
+        1,
+        nibble / 2
+      );
+      write_data(editor, nibble / 2, &byte, 1);
       break;
 
-    case UNDO_WRITE_BYTE:
-      tool_Goto(editor, *(uint24_t*)g_undo_sp);
-      g_undo_sp += sizeof(uint24_t);
-      tool_WriteByte(editor, *g_undo_sp);
+    case UNDO_WRITE_BYTES:
+      byte = *payload;
+      shrink_undo_run(true);
+      tool_Goto(editor, offset + num - 1);
+      push_redo_record(editor, UNDO_WRITE_BYTES, 1, offset + num - 1);
+      write_data(editor, offset + num - 1, &byte, 1);
       break;
 
     case UNDO_INSERT_BYTES:
-      num_bytes = *g_undo_sp++;
-      tool_Goto(editor, (*(uint24_t*)g_undo_sp) + num_bytes - 1);
-      g_undo_sp += sizeof(uint24_t) - 1;
+      pop_undo_record();
+      push_redo_record(editor, code, num, offset);
+      tool_Goto(editor, offset + num - 1);
       editor->selection_active = true;
-      editor->selection_size = num_bytes;
+      editor->selection_size = num;
       tool_DeleteBytes(editor);
       break;
 
+    case UNDO_DELETE_OR_CUT_SPILLED_BYTES:
+    case UNDO_PASTE_SPILLED_BYTES:
     case UNDO_DELETE_OR_CUT_BYTES:
     case UNDO_PASTE_BYTES:
-      g_cutcopy_buffer_size = *g_undo_sp++;
+      g_cutcopy_buffer_size = num;
+
+      // A spilled record's old bytes are in the spill appvar instead.
+      if (
+        code == UNDO_DELETE_OR_CUT_SPILLED_BYTES
+        || code == UNDO_PASTE_SPILLED_BYTES
+      )
+      {
+        unspill_bytes(editor, record, g_cutcopy_buffer);
+        code = (
+          code == UNDO_PASTE_SPILLED_BYTES
+          ? UNDO_PASTE_BYTES
+          : UNDO_DELETE_OR_CUT_BYTES
+        );
+      }
+      else
+        asmutil_CopyData(payload, g_cutcopy_buffer, g_cutcopy_buffer_size, 1);
+
+      pop_undo_record();
+
+      // The redo record for a paste holds the bytes that are about to be
+      // overwritten.
+      push_redo_record(editor, code, num, offset);
 
       if (code != UNDO_PASTE_BYTES)
       {
-        tool_Goto(editor, *(uint24_t*)g_undo_sp);
+        tool_Goto(editor, offset);
         tool_InsertBytes(editor, g_cutcopy_buffer_size);
       }
-      tool_Goto(editor, *(uint24_t*)g_undo_sp + g_cutcopy_buffer_size - 1);
-      g_undo_sp += sizeof(uint24_t);
-      asmutil_CopyData(g_undo_sp, g_cutcopy_buffer, g_cutcopy_buffer_size, 1);
+      tool_Goto(editor, offset + g_cutcopy_buffer_size - 1);
 
       if (g_cutcopy_buffer_size > 1)
       {
@@ -997,16 +2518,24 @@ CCDBG_DUMP_UINT(*(uint24_t*)g_undo_sp);
       }
 
       tool_PasteBytes(editor);
-      g_undo_sp += g_cutcopy_buffer_size - 1;
       g_cutcopy_buffer_size = 0;  // Destroy the cut/copy buffer.
       break;
 
+    case UNDO_REPLACE_BYTES:
+      // The redo record can overlap the popped record, so the matches are
+      // replaced back before the record is copied into the redo log.
+      pop_undo_record();
+      replace_matches(editor, payload, num, offset, true);
+      push_redo_replace(record, offset);
+      break;
+
     default:
       assert(false);
       break;
   }
 
   editor->num_changes--;
+  sync_journal(editor, false);
 
 CCDBG_DUMP_PTR(g_undo_sp);
 CCDBG_ENDBLOCK();
@@ -1015,108 +2544,160 @@ CCDBG_ENDBLOCK();
 }
 
 
-void tool_AddUndo_WriteNibble(s_editor* const editor)
+void tool_RedoLastAction(s_editor* const editor)
 {
-  typedef struct
-  {
-    uint8_t code;
-    uint24_t offset;
-    bool high_nibble;
-    uint8_t nibble;
-  } s_data;
+CCDBG_BEGINBLOCK("tool_RedoLastAction");
+CCDBG_DUMP_PTR(g_redo_sp);
 
-  // <editor->near_size> is guaranteed to be at least one for this operation.
-  uint24_t offset = editor->near_size - 1;
-  uint8_t* address = editor->base_address + offset;
-
-  s_data data = {
-    .code = UNDO_WRITE_NIBBLE,
-    .offset = offset,
-    .high_nibble = editor->high_nibble,
-    .nibble = (
-      editor->high_nibble ? ((*address >> 4) & 0x0f) : (*address & 0x0f)
-    )
-  };
-
-  if (!undo_buffer_has_room(sizeof data))
-    return;
+  assert(!editor->selection_active);
+  assert(editor->undo_buffer_active);
+  assert(g_redo_sp > g_undo_bottom);
 
-  g_undo_sp -= ((sizeof data) - 1);
-  *(s_data*)g_undo_sp = data;
-  g_undo_sp--;
-  editor->num_changes++;
-  return;
-}
+  uint8_t code = g_redo_sp[-1];
+  uint8_t num = g_redo_sp[-2];
+  uint24_t offset = *(uint24_t*)(g_redo_sp - 2 - sizeof(uint24_t));
+  uint24_t payload_size = 0;
+  uint8_t* payload;
+  uint8_t byte;
 
+CCDBG_DUMP_UINT(code);
+CCDBG_DUMP_UINT(offset);
 
-void tool_AddUndo_WriteByte(s_editor* const editor)
-{
-  typedef struct
+  // A replacement's payload size is stored before its offset.
+  if (code == UNDO_REPLACE_BYTES)
   {
-    uint8_t code;
-    uint24_t offset;
-    uint8_t byte;
-  } s_data;
+    payload_size = *(uint24_t*)(g_redo_sp - 2 - 2 * sizeof(uint24_t));
+    g_redo_sp -= sizeof(uint24_t) + payload_size;
+  }
 
-  // <editor->near_size> is guaranteed to be at least one for this operation.
-  uint24_t offset = editor->near_size - 1;
-  uint8_t* address = editor->base_address + offset;
+  // The popped payload stays intact until the change's undo record is added.
+  g_redo_sp -= 2 + sizeof(uint24_t) + redo_payload_size(code, num);
 
-  s_data data = {
-    .code = UNDO_WRITE_BYTE,
-    .offset = offset,
-    .byte = *address
-  };
+  switch (code)
+  {
+    case UNDO_WRITE_HIGH_NIBBLES:
+    case UNDO_WRITE_LOW_NIBBLES:
+      byte = *g_redo_sp;
+      tool_Goto(editor, offset);
+      editor->high_nibble = (code == UNDO_WRITE_HIGH_NIBBLES);
+      addundo_write_nibble(editor);
+      write_data(editor, offset, &byte, 1);
+      break;
 
-  if (!undo_buffer_has_room(sizeof data))
-    return;
+    case UNDO_WRITE_BYTES:
+      byte = *g_redo_sp;
+      tool_Goto(editor, offset);
+      addundo_write_byte(editor);
+      write_data(editor, offset, &byte, 1);
+      break;
 
-  g_undo_sp -= ((sizeof data) - 1);
-  *(s_data*)g_undo_sp = data;
-  g_undo_sp--;
-  editor->num_changes++;
-  return;
-}
+    case UNDO_INSERT_BYTES:
+      if (editor->data_size)
+        tool_Goto(editor, offset);
 
+      addundo_insert_bytes(editor, num);
+      tool_InsertBytes(editor, num);
+      break;
 
-void tool_AddUndo_InsertBytes(s_editor* const editor, const uint8_t num_bytes)
-{
-  typedef struct
-  {
-    uint8_t code;
-    uint8_t num_bytes;
-    uint24_t offset;
-  } s_data;
+    case UNDO_DELETE_OR_CUT_BYTES:
+    case UNDO_PASTE_BYTES:
+      if (code == UNDO_PASTE_BYTES)
+      {
+        g_cutcopy_buffer_size = num;
+        asmutil_CopyData(g_redo_sp, g_cutcopy_buffer, g_cutcopy_buffer_size, 1);
+      }
 
-  uint24_t offset = editor->near_size - (editor->data_size ? 1 : 0);
+      tool_Goto(editor, offset + num - 1);
+      editor->selection_active = true;
+      editor->selection_size = num;
+      addundo_delete_or_cut_or_paste_bytes(editor, code);
 
-  s_data data = {
-    .code = UNDO_INSERT_BYTES,
-    .num_bytes = num_bytes,
-    .offset = offset
-  };
+      if (code == UNDO_PASTE_BYTES)
+      {
+        tool_PasteBytes(editor);
+        g_cutcopy_buffer_size = 0;  // Destroy the cut/copy buffer.
+      }
+      else
+        tool_DeleteBytes(editor);
 
-  if (!undo_buffer_has_room(sizeof data))
-    return;
+      editor->selection_active = false;
+      editor->selection_size = 1;
+      break;
 
-  g_undo_sp -= ((sizeof data) - 1);
-  *(s_data*)g_undo_sp = data;
-  g_undo_sp--;
-  editor->num_changes++;
-  return;
+    case UNDO_REPLACE_BYTES:
+      // The undo record can overlap the popped payload, so the payload is
+      // moved to where the record will keep it before the header is written.
+      if (
+        !make_undo_room(
+          editor, 2 + delta_size(offset - g_undo_offset) + payload_size
+        )
+      )
+      {
+        assert(false);
+        break;
+      }
+
+      memmove(g_undo_sp + 1 - payload_size, g_redo_sp, payload_size);
+      payload = push_undo_record(editor, code, num, offset, payload_size);
+      editor->num_changes++;
+      replace_matches(editor, payload, num, offset, false);
+      break;
+
+    default:
+      assert(false);
+      break;
+  }
+
+  sync_journal(editor, false);
+
+CCDBG_DUMP_PTR(g_redo_sp);
+CCDBG_ENDBLOCK();
+
+  return;
+}
+
+
+void tool_AddUndo_WriteNibble(s_editor* const editor)
+{
+  discard_redo_log();
+  addundo_write_nibble(editor);
+  sync_journal(editor, false);
+  return;
+}
+
+
+void tool_AddUndo_WriteByte(s_editor* const editor)
+{
+  discard_redo_log();
+  addundo_write_byte(editor);
+  sync_journal(editor, false);
+  return;
+}
+
+
+void tool_AddUndo_InsertBytes(s_editor* const editor, const uint8_t num_bytes)
+{
+  discard_redo_log();
+  addundo_insert_bytes(editor, num_bytes);
+  sync_journal(editor, false);
+  return;
 }
 
 
 void tool_AddUndo_DeleteOrCutBytes(s_editor* const editor)
 {
+  discard_redo_log();
   addundo_delete_or_cut_or_paste_bytes(editor, UNDO_DELETE_OR_CUT_BYTES);
+  sync_journal(editor, false);
   return;
 }
 
 
 void tool_AddUndo_PasteBytes(s_editor* const editor)
 {
+  discard_redo_log();
   addundo_delete_or_cut_or_paste_bytes(editor, UNDO_PASTE_BYTES);
+  sync_journal(editor, false);
   return;
 }
 
@@ -1126,43 +2707,174 @@ void tool_AddUndo_PasteBytes(s_editor* const editor)
 // =============================================================================
 
 
-static bool shrink_edit_buffer(const s_editor* const editor)
+static void save_tab(void)
 {
-CCDBG_BEGINBLOCK("shrink_edit_buffer");
+  s_tab* const tab = &g_tabs[g_active_tab];
+
+  tab->undo_size = g_undo_top - g_undo_sp;
+  tab->undo_offset = g_undo_offset;
+  tab->redo_size = g_redo_sp - g_undo_bottom;
+  memcpy(tab->page_slots, g_page_slots, sizeof g_page_slots);
+  tab->num_pages_loaded = g_num_pages_loaded;
+  memcpy(tab->dirty_ranges, g_dirty_ranges, sizeof g_dirty_ranges);
+  tab->num_dirty_ranges = g_num_dirty_ranges;
+  return;
+}
 
-  // <editor->near_size> is guaranteed to be at least one IF the edit buffer
-  // has data in it.
-  uint8_t* src = (
-    editor->base_address + editor->near_size - (editor->data_size ? 1 : 0)
-  );
-  uint8_t* dest;
-  bool retval = false;
-  uint8_t handle;
-  int resized;
 
-  if (editor->far_size)
+static void load_tab(const uint8_t tab)
+{
+  assert(tab < g_num_tabs);
+
+  g_active_tab = tab;
+  g_undo_top = undo_top(tab);
+  g_undo_bottom = undo_bottom(tab);
+  g_undo_sp = g_undo_top - g_tabs[tab].undo_size;
+  g_undo_offset = g_tabs[tab].undo_offset;
+  g_redo_sp = g_undo_bottom + g_tabs[tab].redo_size;
+  memcpy(g_page_slots, g_tabs[tab].page_slots, sizeof g_page_slots);
+  g_num_pages_loaded = g_tabs[tab].num_pages_loaded;
+  memcpy(g_dirty_ranges, g_tabs[tab].dirty_ranges, sizeof g_dirty_ranges);
+  g_num_dirty_ranges = g_tabs[tab].num_dirty_ranges;
+  return;
+}
+
+
+static uint8_t* undo_top(const uint8_t tab)
+{
+  return g_undo_stack + (tab + 1) * ((sizeof g_undo_stack) / g_num_tabs) - 1;
+}
+
+
+static uint8_t* undo_bottom(const uint8_t tab)
+{
+  return g_undo_stack + tab * ((sizeof g_undo_stack) / g_num_tabs);
+}
+
+
+static void share_undo_stack(
+  uint8_t* const old_tops[], const uint24_t old_share
+)
+{
+  uint8_t* old_bottom;
+  uint24_t size;
+  uint8_t tab;
+
+  // The shares keep their order, and so do the redo and undo records in each
+  // share, so moving the records that move down from the first tab to the
+  // last, and then the records that move up from the last tab to the first,
+  // never overwrites records that have not been moved yet.
+  for (tab = 0; tab < g_num_tabs; tab++)
   {
-    dest = editor->base_address + editor->buffer_size - editor->far_size - 1;
-    asmutil_CopyData(src, dest, editor->near_size, 0);
+    old_bottom = old_tops[tab] + 1 - old_share;
+
+    if (undo_bottom(tab) < old_bottom)
+      memmove(undo_bottom(tab), old_bottom, g_tabs[tab].redo_size);
+
+    size = g_tabs[tab].undo_size;
+
+    if (undo_top(tab) < old_tops[tab])
+      memmove(undo_top(tab) - size + 1, old_tops[tab] - size + 1, size);
   }
 
-  if ((handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+  for (tab = g_num_tabs; tab-- > 0;)
   {
-    resized = ti_Resize(editor->data_size, handle);
+    size = g_tabs[tab].undo_size;
 
-    // If the edit buffer appvar is of the maximum size, ti_Resize() will
-    // return 0 because the variable cannot be resized. This is a valid
-    // state, so it will not be treated as an error.
-    if (resized <= 0 && editor->data_size != MAX_VAR_DATA_SIZE)
-      retval = false;
-    else
-      retval = true;
+    if (undo_top(tab) > old_tops[tab])
+      memmove(undo_top(tab) - size + 1, old_tops[tab] - size + 1, size);
+
+    old_bottom = old_tops[tab] + 1 - old_share;
+
+    if (undo_bottom(tab) > old_bottom)
+      memmove(undo_bottom(tab), old_bottom, g_tabs[tab].redo_size);
+  }
+
+  return;
+}
+
+
+static uint24_t region_offset(const uint8_t tab)
+{
+  uint24_t offset = 0;
+
+  for (uint8_t idx = tab + 1; idx < g_num_tabs; idx++)
+    offset += g_tabs[idx].region_size;
+
+  return offset;
+}
+
+
+static uint24_t other_regions_size(void)
+{
+  uint24_t size = 0;
+
+  for (uint8_t idx = 0; idx < g_num_tabs; idx++)
+  {
+    if (idx != g_active_tab)
+      size += g_tabs[idx].region_size;
+  }
 
-CCDBG_DUMP_UINT(ti_GetSize(handle));
+  return size;
+}
+
+
+static bool resize_region(s_editor* const editor, const uint24_t size)
+{
+CCDBG_BEGINBLOCK("resize_region");
+CCDBG_DUMP_UINT(g_tabs[g_active_tab].region_size);
+CCDBG_DUMP_UINT(size);
+
+  s_tab* const tab = &g_tabs[g_active_tab];
+  uint24_t offset = region_offset(g_active_tab);
+  uint24_t buffer_size;
+  uint24_t new_buffer_size;
+  uint8_t* buffer = tool_EditBufferPtr(&buffer_size);
+  uint8_t handle;
+  bool retval = false;
+
+  if (size == tab->region_size)
+  {
+CCDBG_ENDBLOCK();
+    return true;
+  }
+
+  new_buffer_size = buffer_size - tab->region_size + size;
+
+  // ti_Resize() removes bytes from the start of the appvar, so the regions
+  // before this one are moved up over the bytes being removed first.
+  if (size < tab->region_size)
+  {
+    asmutil_CopyData(
+      buffer + offset - 1,
+      buffer + offset + tab->region_size - size - 1,
+      offset,
+      0
+    );
+  }
 
+  if ((handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+  {
+    ti_Resize(new_buffer_size, handle);
+    retval = (ti_GetSize(handle) == new_buffer_size);
     ti_Close(handle);
   }
 
+  buffer = tool_EditBufferPtr(&buffer_size);
+
+  // ti_Resize() inserts bytes at the start of the appvar, so the regions
+  // before this one are moved back down to the start. If the appvar could not
+  // shrink, the regions are moved back to where they were.
+  if (retval && size > tab->region_size)
+    asmutil_CopyData(buffer + size - tab->region_size, buffer, offset, 1);
+  else if (!retval && size < tab->region_size)
+    asmutil_CopyData(buffer + tab->region_size - size, buffer, offset, 1);
+
+  if (retval)
+    tab->region_size = size;
+
+  update_base_address(editor);
+
 CCDBG_DUMP_UINT(retval);
 CCDBG_ENDBLOCK();
 
@@ -1170,20 +2882,55 @@ CCDBG_ENDBLOCK();
 }
 
 
-static bool archive_edit_buffer(void)
+static void update_base_address(s_editor* const editor)
 {
-CCDBG_BEGINBLOCK("archive_edit_buffer");
+  uint24_t buffer_size;
 
-  bool retval = false;
-  uint8_t handle;
+  // Memory editors do not use the edit buffer.
+  if (!editor->is_tios_var)
+    return;
 
-  if ((handle = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+  editor->base_address = (
+    (uint8_t*)tool_EditBufferPtr(&buffer_size) + region_offset(g_active_tab)
+  );
+  editor->buffer_size = g_tabs[g_active_tab].region_size;
+
+  if (editor->paged)
+    g_num_page_slots = min(editor->buffer_size / EDIT_PAGE_SIZE, UINT8_MAX);
+
+  return;
+}
+
+
+static void update_var_data(s_editor* const editor)
+{
+  s_calc_var var;
+
+  if (
+    editor->paged
+    && hevat_GetVarInfoByNameAndType(
+      &var, editor->name, editor->name_length, editor->tios_var_type
+    )
+  )
   {
-    ti_SetArchiveStatus(true, handle);
-    ti_Close(handle);
-    retval = true;
+    editor->var_data = var.data + (var.named ? 2 : 0);
   }
 
+  return;
+}
+
+
+static bool shrink_edit_buffer(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("shrink_edit_buffer");
+
+  bool retval;
+
+  // The region shrinks from its start, so all of the data must be moved to the
+  // end of the region first.
+  move_gap(editor, 0);
+  retval = resize_region(editor, editor->data_size);
+
 CCDBG_DUMP_UINT(retval);
 CCDBG_ENDBLOCK();
 
@@ -1191,55 +2938,62 @@ CCDBG_ENDBLOCK();
 }
 
 
-static bool save_edited_var(s_calc_var* const var)
+static bool stream_var(s_editor* const editor, s_calc_var* const var)
 {
-CCDBG_BEGINBLOCK("save_edited_var");
+CCDBG_BEGINBLOCK("stream_var");
 
   bool retval = false;
-  uint8_t handle_buffer;
-  uint8_t handle_var;
+  uint8_t handle;
+  uint24_t var_size = (var->archived ? 0 : var->size - (var->named ? 2 : 0));
+  uint24_t growth = 0;
+
+  if (editor->data_size > var_size)
+    growth = editor->data_size - var_size;
 
-  if ((handle_buffer = ti_Open(G_EDIT_BUFFER_APPVAR_NAME, "r")))
+CCDBG_DUMP_UINT(growth);
+
+  // The gap can only be given back to the OS by moving the data before it, so
+  // that is only done if the variable cannot grow otherwise.
+  if (!tool_CheckFreeRAM(growth))
+    shrink_edit_buffer(editor);
+
+  // An archived variable is replaced instead of being unarchived, which would
+  // only copy data that is about to be overwritten. Opening it for writing
+  // deletes it, so this must not fail after that.
+  if (!tool_CheckFreeRAM(growth))
   {
-    if ((handle_var = ti_OpenVar(var->name, "w", var->type)))
-    {
-      ti_Resize(ti_GetSize(handle_buffer), handle_var);
+CCDBG_PUTS("Not enough RAM to resize variable");
+CCDBG_ENDBLOCK();
 
-      if (ti_GetSize(handle_var) == ti_GetSize(handle_buffer))
-      {
-        asmutil_CopyData(
-          ti_GetDataPtr(handle_buffer),
-          ti_GetDataPtr(handle_var),
-          ti_GetSize(handle_buffer),
-          1
-        );
+    return false;
+  }
 
-        if (ti_SetArchiveStatus(var->archived, handle_var))
-          retval = true;
-        else
-        {
-CCDBG_PUTS("Could not archive variable");
-        }
-      }
+  if ((handle = ti_OpenVar(var->name, var->archived ? "w" : "r+", var->type)))
+  {
+    ti_Resize(editor->data_size, handle);
+
+    if (ti_GetSize(handle) == editor->data_size)
+    {
+      // Resizing the variable can move the edit buffer in RAM.
+      update_base_address(editor);
+      read_data(editor, 0, ti_GetDataPtr(handle), editor->data_size);
+
+      if (ti_SetArchiveStatus(var->archived, handle))
+        retval = true;
       else
       {
-CCDBG_PUTS("Variable not resized");
+CCDBG_PUTS("Could not archive variable");
       }
-
-      ti_Close(handle_var);
     }
     else
     {
-CCDBG_PUTS("Variable not opened");
+CCDBG_PUTS("Variable not resized");
     }
 
-    ti_Close(handle_buffer);
-  }
-  else
-  {
-CCDBG_PUTS("Edit buffer not opened");
+    ti_Close(handle);
   }
 
+CCDBG_DUMP_UINT(retval);
 CCDBG_ENDBLOCK();
 
   return retval;
@@ -1248,50 +3002,2109 @@ CCDBG_ENDBLOCK();
 
 static bool undo_buffer_has_room(const uint24_t size)
 {
-  if (g_undo_sp < g_undo_stack + size)
-  {
-    assert(false && "TODO: Mention undo buffer is full");
+  return (g_undo_sp >= g_redo_sp + size);
+}
+
+
+static bool can_evict_undo(const s_editor* const editor)
+{
+  return (editor->is_tios_var && !editor->in_place);
+}
+
+
+static bool undo_record_fits(const s_editor* const editor)
+{
+  // Any new change discards the redo log before its undo record is added.
+  return (
+    can_evict_undo(editor)
+    || g_undo_sp >= g_undo_bottom + MAX_UNDO_RECORD_SIZE
+  );
+}
+
+
+static bool make_undo_room(s_editor* const editor, const uint24_t size)
+{
+  uint8_t* const end = g_undo_top + 1;
+  uint8_t* record = g_undo_sp + 1;
+  uint8_t* evicted;
+  uint24_t record_size;
+  uint24_t kept_size;
+  uint24_t spilled_size = 0;
+
+  if (undo_buffer_has_room(size))
+    return true;
+
+  if (!can_evict_undo(editor) || end < g_redo_sp + size)
     return false;
+
+  // Only variables edited in place keep a journal.
+  assert(g_tabs[g_active_tab].journal == NO_JOURNAL);
+
+  // Keep the newest records that leave enough room.
+  kept_size = (end - g_redo_sp) - min(
+    max(size, UNDO_EVICTION_SIZE), (uint24_t)(end - g_redo_sp)
+  );
+
+  while (
+    record < end
+    && (uint24_t)(record - (g_undo_sp + 1))
+       + (record_size = undo_record_size(record)) <= kept_size
+  )
+  {
+    record += record_size;
+  }
+
+  editor->num_changes -= count_undo_changes(record, end);
+  editor->undo_evicted = true;
+
+  for (evicted = record; evicted < end; evicted += undo_record_size(evicted))
+  {
+    if (
+      evicted[0] == UNDO_PASTE_SPILLED_BYTES
+      || evicted[0] == UNDO_DELETE_OR_CUT_SPILLED_BYTES
+    )
+      spilled_size += evicted[undo_header_size(evicted)];
   }
 
+  drop_spilled_bytes(editor, spilled_size);
+
+  // The newest records move to the top of the undo stack. Their offset deltas
+  // do not depend on the evicted records.
+  kept_size = record - (g_undo_sp + 1);
+  memmove(end - kept_size, g_undo_sp + 1, kept_size);
+  g_undo_sp = end - kept_size - 1;
   return true;
 }
 
 
+static void addundo_write_nibble(s_editor* const editor)
+{
+  // <editor->near_size> is guaranteed to be at least one for this operation.
+  uint24_t offset = editor->near_size - 1;
+  uint24_t nibble = 2 * offset + !editor->high_nibble;
+  uint8_t* record = g_undo_sp + 1;
+  uint8_t* payload;
+
+  // A nibble written right after the newest run's last nibble joins the run.
+  // Its byte's old value is only stored if the byte is new to the run.
+  if (
+    g_undo_sp < g_undo_top
+    && (
+      record[0] == UNDO_WRITE_HIGH_NIBBLES
+      || record[0] == UNDO_WRITE_LOW_NIBBLES
+    )
+    && record[1] < UINT8_MAX
+    && nibble == (
+      2 * g_undo_offset + (record[0] == UNDO_WRITE_LOW_NIBBLES) + record[1]
+    )
+  )
+  {
+    if (!editor->high_nibble)
+    {
+      unsync_journal_top();
+      record[1]++;
+      editor->num_changes++;
+      return;
+    }
+
+    // A run that cannot grow without evicting records is ended instead.
+    if ((payload = grow_undo_run()))
+    {
+      *payload = *tool_DataPtr(editor, offset);
+      editor->num_changes++;
+      return;
+    }
+  }
+
+  payload = push_undo_record(
+    editor,
+    editor->high_nibble ? UNDO_WRITE_HIGH_NIBBLES : UNDO_WRITE_LOW_NIBBLES,
+    1,
+    offset,
+    1
+  );
+
+  if (!payload)
+    return;
+
+  *payload = *tool_DataPtr(editor, offset);
+  editor->num_changes++;
+  return;
+}
+
+
+static void addundo_write_byte(s_editor* const editor)
+{
+  // <editor->near_size> is guaranteed to be at least one for this operation.
+  uint24_t offset = editor->near_size - 1;
+  uint8_t* record = g_undo_sp + 1;
+  uint8_t* payload = NULL;
+
+  // A byte written right after the newest run's last byte joins the run, if
+  // the run can grow without evicting records.
+  if (
+    g_undo_sp < g_undo_top
+    && record[0] == UNDO_WRITE_BYTES
+    && record[1] < UINT8_MAX
+    && offset == g_undo_offset + record[1]
+  )
+    payload = grow_undo_run();
+
+  if (!payload)
+    payload = push_undo_record(editor, UNDO_WRITE_BYTES, 1, offset, 1);
+
+  if (!payload)
+    return;
+
+  *payload = *tool_DataPtr(editor, offset);
+  editor->num_changes++;
+  return;
+}
+
+
+static void addundo_insert_bytes(
+  s_editor* const editor, const uint8_t num_bytes
+)
+{
+  uint24_t offset = editor->near_size - (editor->data_size ? 1 : 0);
+
+  // The record has no payload, so only a NULL return means it did not fit.
+  if (push_undo_record(editor, UNDO_INSERT_BYTES, num_bytes, offset, 0))
+    editor->num_changes++;
+
+  return;
+}
+
+
 static void addundo_delete_or_cut_or_paste_bytes(
   s_editor* const editor, const uint8_t code
 )
 {
-  typedef struct
-  {
-    uint8_t code;
-    uint8_t num_bytes;
-    uint24_t offset;
-    uint8_t* data[G_MAX_SELECTION_SIZE];
-  } s_data;
-
   // <editor->near_size> is guaranteed to be at least the same size as
   // <editor->selection_size> for this operation.
   uint24_t offset = editor->near_size - editor->selection_size;
+  uint8_t* payload;
 
-  s_data data = {
-    .code = code,
-    .num_bytes = editor->selection_size,
-    .offset = offset
-  };
+  if (spill_undo_record(editor, code))
+  {
+    editor->num_changes++;
+    return;
+  }
+
+  payload = push_undo_record(
+    editor, code, editor->selection_size, offset, editor->selection_size
+  );
 
-  if (!undo_buffer_has_room(sizeof data))
+  if (!payload)
     return;
 
-  g_undo_sp -= data.num_bytes - 1;
-  asmutil_CopyData(editor->base_address + offset, g_undo_sp, data.num_bytes, 1);
-  g_undo_sp -= sizeof data.offset;
-  *(uint24_t*)g_undo_sp = data.offset;
-  g_undo_sp -= sizeof data.num_bytes;
-  *g_undo_sp = data.num_bytes;
-  g_undo_sp -= sizeof data.code;
-  *g_undo_sp = data.code;
-  g_undo_sp--;
+  read_data(editor, offset, payload, editor->selection_size);
   editor->num_changes++;
   return;
 }
+
+
+static uint8_t delta_size(const uint24_t delta)
+{
+  return ((uint24_t)(delta + 127) <= 254 ? 1 : 1 + sizeof(uint24_t));
+}
+
+
+static uint8_t undo_header_size(const uint8_t* const record)
+{
+  return 2 + (record[2] == UNDO_LONG_DELTA ? 1 + sizeof(uint24_t) : 1);
+}
+
+
+static uint24_t undo_delta(const uint8_t* const record)
+{
+  if (record[2] == UNDO_LONG_DELTA)
+    return *(uint24_t*)(record + 3);
+
+  // Sign-extend the one-byte delta.
+  return (int8_t)record[2];
+}
+
+
+static uint24_t undo_record_size(const uint8_t* const record)
+{
+  const s_replace_header* replace;
+  uint24_t size = undo_header_size(record);
+
+  switch (record[0])
+  {
+    case UNDO_WRITE_HIGH_NIBBLES:
+    case UNDO_WRITE_LOW_NIBBLES:
+      size += (record[1] + (record[0] == UNDO_WRITE_LOW_NIBBLES) + 1) / 2;
+      break;
+
+    case UNDO_WRITE_BYTES:
+    case UNDO_PASTE_BYTES:
+    case UNDO_DELETE_OR_CUT_BYTES:
+      size += record[1];
+      break;
+
+    case UNDO_PASTE_SPILLED_BYTES:
+    case UNDO_DELETE_OR_CUT_SPILLED_BYTES:
+      size++;
+      break;
+
+    case UNDO_REPLACE_BYTES:
+      replace = (const s_replace_header*)(record + size);
+      size += (
+        sizeof *replace + record[1] + replace->replacement_length
+        + replace->gaps_size
+      );
+      break;
+
+    default:
+      break;
+  }
+
+  return size;
+}
+
+
+static uint8_t* push_undo_record(
+  s_editor* const editor,
+  const uint8_t code,
+  const uint8_t num,
+  const uint24_t offset,
+  const uint24_t payload_size
+)
+{
+  uint24_t delta = offset - g_undo_offset;
+  uint8_t header_size = 2 + delta_size(delta);
+
+  if (!make_undo_room(editor, header_size + payload_size))
+    return NULL;
+
+  g_undo_sp -= header_size + payload_size;
+  g_undo_sp[1] = code;
+  g_undo_sp[2] = num;
+
+  if (header_size == 3)
+    g_undo_sp[3] = (uint8_t)delta;
+  else
+  {
+    g_undo_sp[3] = UNDO_LONG_DELTA;
+    *(uint24_t*)(g_undo_sp + 4) = delta;
+  }
+
+  g_undo_offset = offset;
+  return g_undo_sp + 1 + header_size;
+}
+
+
+static void pop_undo_record(void)
+{
+  uint8_t* record = g_undo_sp + 1;
+
+  unsync_journal_top();
+
+  g_undo_offset -= undo_delta(record);
+  g_undo_sp += undo_record_size(record);
+  return;
+}
+
+
+static uint8_t* grow_undo_run(void)
+{
+  uint8_t header_size = undo_header_size(g_undo_sp + 1);
+
+  unsync_journal_top();
+
+  if (!undo_buffer_has_room(1))
+    return NULL;
+
+  // The header moves down a byte to make room for the new old value after it.
+  memmove(g_undo_sp, g_undo_sp + 1, header_size);
+  g_undo_sp[1]++;
+  g_undo_sp--;
+  return g_undo_sp + 1 + header_size;
+}
+
+
+static void shrink_undo_run(const bool drop_byte)
+{
+  uint8_t* record = g_undo_sp + 1;
+  uint8_t header_size = undo_header_size(record);
+
+  unsync_journal_top();
+
+  if (record[1] == 1)
+  {
+    pop_undo_record();
+    return;
+  }
+
+  record[1]--;
+
+  // The header moves up a byte over the newest old value.
+  if (drop_byte)
+  {
+    memmove(record + 1, record, header_size);
+    g_undo_sp++;
+  }
+
+  return;
+}
+
+
+static void discard_redo_log(void)
+{
+  g_redo_sp = g_undo_bottom;
+  return;
+}
+
+
+static uint24_t redo_payload_size(const uint8_t code, const uint8_t num)
+{
+  switch (code)
+  {
+    case UNDO_WRITE_HIGH_NIBBLES:
+    case UNDO_WRITE_LOW_NIBBLES:
+    case UNDO_WRITE_BYTES:
+      return 1;
+
+    case UNDO_PASTE_BYTES:
+      return num;
+
+    default:
+      return 0;
+  }
+}
+
+
+static void push_redo_record(
+  const s_editor* const editor,
+  const uint8_t code,
+  const uint8_t num,
+  const uint24_t offset
+)
+{
+  uint24_t payload_size = redo_payload_size(code, num);
+
+  // Redo records must be re-applied in order, so none may be skipped.
+  if (g_undo_sp < g_redo_sp + payload_size + 2 + sizeof(uint24_t))
+  {
+    discard_redo_log();
+    return;
+  }
+
+  read_data(editor, offset, g_redo_sp, payload_size);
+  g_redo_sp += payload_size;
+  *(uint24_t*)g_redo_sp = offset;
+  g_redo_sp += sizeof(uint24_t);
+  *g_redo_sp++ = num;
+  *g_redo_sp++ = code;
+  return;
+}
+
+
+static void push_redo_replace(
+  const uint8_t* const record, const uint24_t offset
+)
+{
+  uint8_t header_size = undo_header_size(record);
+  uint24_t payload_size = undo_record_size(record) - header_size;
+  uint8_t num = record[1];
+
+  if (g_undo_sp < g_redo_sp + payload_size + 2 + 2 * sizeof(uint24_t))
+  {
+    discard_redo_log();
+    return;
+  }
+
+  // The redo record can overlap the popped record, so the header is read
+  // before anything is copied.
+  memmove(g_redo_sp, record + header_size, payload_size);
+  g_redo_sp += payload_size;
+  *(uint24_t*)g_redo_sp = payload_size;
+  g_redo_sp += sizeof(uint24_t);
+  *(uint24_t*)g_redo_sp = offset;
+  g_redo_sp += sizeof(uint24_t);
+  *g_redo_sp++ = num;
+  *g_redo_sp++ = UNDO_REPLACE_BYTES;
+  return;
+}
+
+
+static void move_gap(s_editor* const editor, const uint24_t offset)
+{
+  assert(offset <= editor->data_size);
+
+  uint8_t* far_start = tool_DataPtr(editor, editor->gap_offset);
+  uint24_t gap_size = editor->buffer_size - editor->data_size;
+
+  // Memory editors have no gap, so there is nothing to copy.
+  if (gap_size && offset < editor->gap_offset)
+  {
+    // Copy backwards because the source and destination may overlap.
+    asmutil_CopyData(
+      editor->base_address + editor->gap_offset - 1,
+      far_start - 1,
+      editor->gap_offset - offset,
+      0
+    );
+  }
+  else if (gap_size && offset > editor->gap_offset)
+  {
+    asmutil_CopyData(
+      far_start,
+      editor->base_address + editor->gap_offset,
+      offset - editor->gap_offset,
+      1
+    );
+  }
+
+  editor->gap_offset = offset;
+  return;
+}
+
+
+static void read_data(
+  const s_editor* const editor,
+  const uint24_t offset,
+  uint8_t* const dest,
+  const uint24_t amount
+)
+{
+  uint24_t start = offset;
+  uint24_t copy_size;
+
+  while (start < offset + amount)
+  {
+    copy_size = min(segment_end(editor, start), offset + amount) - start;
+    asmutil_CopyData(
+      tool_DataPtr(editor, start), dest + start - offset, copy_size, 1
+    );
+    start += copy_size;
+  }
+
+  return;
+}
+
+
+static void write_data(
+  s_editor* const editor,
+  const uint24_t offset,
+  const uint8_t* const src,
+  const uint24_t amount
+)
+{
+  uint24_t start = offset;
+  uint24_t copy_size;
+
+  load_pages(editor, offset, amount);
+  mark_dirty(offset, offset + amount);
+
+  while (start < offset + amount)
+  {
+    copy_size = min(segment_end(editor, start), offset + amount) - start;
+    asmutil_CopyData(
+      (uint8_t*)src + start - offset, tool_DataPtr(editor, start), copy_size, 1
+    );
+    start += copy_size;
+  }
+
+  return;
+}
+
+
+static bool find_phrase_forward(
+  const s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t offset,
+  const uint24_t last,
+  uint24_t* const match
+)
+{
+  const uint8_t* start;
+  uint24_t found;
+  uint24_t size;
+  uint24_t end;
+  uint8_t num_found;
+  uint8_t idx;
+
+  while (offset <= last)
+  {
+    end = search_segment(editor, &offset);
+
+    if (offset > last)
+      break;
+
+    size = min(end, last + length) - offset;
+    start = tool_DataPtr(editor, offset);
+
+    num_found = 0;
+
+    if (size >= length && mask)
+    {
+      num_found = asmutil_FindMaskedPhrase(
+        start, start + size - 1, phrase, mask, length, &found, 1
+      );
+    }
+    else if (size >= length)
+    {
+      num_found = asmutil_FindPhrase(
+        start, start + size - 1, phrase, length, &found, 1
+      );
+    }
+
+    if (num_found)
+    {
+      *match = offset + (found - (uint24_t)start);
+      return true;
+    }
+
+    // A match in the ports region does not cross into the next range, which
+    // may not be safe to read.
+    if (is_ports_editor(editor))
+    {
+      offset = end;
+      continue;
+    }
+
+    for (
+      offset = end - min(end - offset, (uint24_t)(length - 1));
+      offset < end && offset <= last;
+      offset++
+    )
+    {
+      for (idx = 0; idx < length; idx++)
+      {
+        if (
+          (*tool_DataPtr(editor, offset + idx) & (mask ? mask[idx] : 0xff))
+          != phrase[idx]
+        )
+        {
+          break;
+        }
+      }
+
+      if (idx == length)
+      {
+        *match = offset;
+        return true;
+      }
+    }
+
+    offset = end;
+  }
+
+  return false;
+}
+
+
+static bool can_replace(
+  const s_editor* const editor,
+  const s_replace_header* const header,
+  const uint8_t phrase_length,
+  const uint24_t num_new_pages,
+  const bool undo
+)
+{
+  uint8_t from_length = (undo ? header->replacement_length : phrase_length);
+  uint8_t to_length = (undo ? phrase_length : header->replacement_length);
+  uint24_t size = editor->data_size;
+
+  // Variables edited in place are overwritten where they are, and paged
+  // variables only load the pages that the matches touch if there is room.
+  if (from_length == to_length)
+  {
+    return (
+      editor->in_place
+      || pages_fit(editor, num_new_pages)
+      || can_unpage(editor)
+    );
+  }
+
+  if (to_length > from_length)
+    size += header->num_matches * (to_length - from_length);
+
+  return (
+    editor->is_tios_var
+    && editor->access_type == 'i'
+    && can_unpage(editor)
+    && can_grow_edit_buffer(editor, size)
+  );
+}
+
+
+static uint24_t replace_pages(
+  const s_editor* const editor,
+  const uint8_t* const payload,
+  const uint8_t phrase_length,
+  const uint24_t offset
+)
+{
+  const s_replace_header* header = (const s_replace_header*)payload;
+  const uint8_t* gap = (
+    payload + sizeof *header + phrase_length + header->replacement_length
+  );
+  uint24_t match = offset;
+  uint24_t next_page = 0;
+  uint24_t num_new_pages = 0;
+
+  if (
+    !editor->paged
+    || editor->in_place
+    || header->replacement_length != phrase_length
+  )
+    return 0;
+
+  for (uint24_t idx = 0; idx < header->num_matches; idx++)
+  {
+    if (idx)
+      match += phrase_length + read_replace_gap(&gap);
+
+    count_new_pages(match, phrase_length, &next_page, &num_new_pages);
+  }
+
+  return num_new_pages;
+}
+
+
+static uint24_t read_replace_gap(const uint8_t** const gap)
+{
+  uint24_t size = *(*gap)++;
+
+  if (size == REPLACE_LONG_GAP)
+  {
+    size = *(const uint24_t*)*gap;
+    *gap += sizeof(uint24_t);
+  }
+
+  return size;
+}
+
+
+static void replace_matches(
+  s_editor* const editor,
+  const uint8_t* const payload,
+  const uint8_t phrase_length,
+  const uint24_t offset,
+  const bool undo
+)
+{
+CCDBG_BEGINBLOCK("replace_matches");
+CCDBG_DUMP_UINT(offset);
+CCDBG_DUMP_UINT(undo);
+
+  const s_replace_header* header = (const s_replace_header*)payload;
+  const uint8_t* phrase = payload + sizeof *header;
+  const uint8_t* replacement = phrase + phrase_length;
+  const uint8_t* gap = replacement + header->replacement_length;
+  const uint8_t* to = (undo ? phrase : replacement);
+  uint8_t from_length = (undo ? header->replacement_length : phrase_length);
+  uint8_t to_length = (undo ? phrase_length : header->replacement_length);
+  uint24_t match = offset;
+  uint24_t size;
+  uint8_t* src;
+  uint8_t* dest;
+
+CCDBG_DUMP_UINT(header->num_matches);
+
+  if (from_length == to_length)
+  {
+    // Overwriting the matches does not change the data's size, so the gap can
+    // stay where it is. The pages that the matches touch are loaded as they
+    // are written, unless there is no room for all of them.
+    if (
+      !editor->in_place
+      && !pages_fit(
+        editor, replace_pages(editor, payload, phrase_length, offset)
+      )
+    )
+      unpage_data(editor);
+
+    for (uint24_t idx = 0; idx < header->num_matches; idx++)
+    {
+      if (idx)
+        match += from_length + read_replace_gap(&gap);
+
+      write_data(editor, match, to, to_length);
+    }
+  }
+  else
+  {
+    unpage_data(editor);
+
+    if (to_length > from_length)
+    {
+      grow_edit_buffer(
+        editor,
+        editor->data_size + header->num_matches * (to_length - from_length)
+      );
+    }
+
+    // Everything from the first match on is moved after the gap, and then
+    // copied back before it with each match replaced. The gap is at least as
+    // large as the data's growth, so the copy never catches up with the data
+    // it has not read yet.
+    move_gap(editor, offset);
+    src = tool_DataPtr(editor, offset);
+    dest = editor->base_address + offset;
+
+    for (uint24_t idx = 0; idx < header->num_matches; idx++)
+    {
+      if (idx)
+      {
+        size = read_replace_gap(&gap);
+        asmutil_CopyData(src, dest, size, 1);
+        src += size;
+        dest += size;
+      }
+
+      asmutil_CopyData((uint8_t*)to, dest, to_length, 1);
+      src += from_length;
+      dest += to_length;
+    }
+
+    editor->gap_offset = dest - editor->base_address;
+    editor->data_size = (
+      editor->gap_offset + (editor->base_address + editor->buffer_size - src)
+    );
+
+    // Every byte after the first match may have moved.
+    mark_dirty(offset, editor->data_size);
+  }
+
+  set_cursor(editor, offset);
+
+CCDBG_ENDBLOCK();
+  return;
+}
+
+
+static bool undo_fits(const s_editor* const editor)
+{
+  const uint8_t* record = g_undo_sp + 1;
+
+  // Undoing a deletion inserts its bytes again.
+  if (
+    record[0] == UNDO_DELETE_OR_CUT_BYTES
+    || record[0] == UNDO_DELETE_OR_CUT_SPILLED_BYTES
+  )
+    return tool_CanInsertBytes(editor, record[1]);
+
+  // Undoing a replacement can change the data's size.
+  if (record[0] == UNDO_REPLACE_BYTES)
+  {
+    return can_replace(
+      editor,
+      (const s_replace_header*)(record + undo_header_size(record)),
+      record[1],
+      replace_pages(
+        editor, record + undo_header_size(record), record[1], g_undo_offset
+      ),
+      true
+    );
+  }
+
+  return true;
+}
+
+
+static bool redo_fits(const s_editor* const editor)
+{
+  uint24_t record_size = MAX_UNDO_RECORD_SIZE;
+  uint24_t payload_size;
+  const uint8_t* payload;
+
+  // A replacement's undo record is as large as its redo record's payload, and
+  // redoing it can change the data's size.
+  if (g_redo_sp[-1] == UNDO_REPLACE_BYTES)
+  {
+    payload_size = *(uint24_t*)(g_redo_sp - 2 - 2 * sizeof(uint24_t));
+    record_size = 3 + sizeof(uint24_t) + payload_size;
+
+    payload = g_redo_sp - 2 - 2 * sizeof(uint24_t) - payload_size;
+
+    if (
+      !can_replace(
+        editor,
+        (const s_replace_header*)payload,
+        g_redo_sp[-2],
+        replace_pages(
+          editor,
+          payload,
+          g_redo_sp[-2],
+          *(uint24_t*)(g_redo_sp - 2 - sizeof(uint24_t))
+        ),
+        false
+      )
+    )
+      return false;
+  }
+
+  if (
+    g_redo_sp[-1] == UNDO_INSERT_BYTES
+    && !tool_CanInsertBytes(editor, g_redo_sp[-2])
+  )
+    return false;
+
+  // The undo record for the change must fit alongside the redo log, by
+  // evicting older undo records if they may be evicted.
+  return (
+    (can_evict_undo(editor) ? g_undo_top + 1 : g_undo_sp)
+    >= g_redo_sp + record_size
+  );
+}
+
+
+static int8_t save_paged_var(s_editor* const editor, s_calc_var* const var)
+{
+CCDBG_BEGINBLOCK("save_paged_var");
+
+  // Release the unused page slots so the OS has room to unarchive the
+  // variable. The region shrinks from its start, which is where the unused
+  // slots are.
+  resize_region(editor, g_num_pages_loaded * EDIT_PAGE_SIZE);
+
+  // The whole variable is unarchived to be patched. Without the RAM for it,
+  // nothing is changed, so the changes can be saved once RAM is freed.
+  if (var->archived && !tool_CheckFreeRAM(var->size))
+  {
+CCDBG_PUTS("Not enough RAM to unarchive variable");
+CCDBG_ENDBLOCK();
+
+    return 0;
+  }
+
+  if (!patch_var(editor, var))
+  {
+    // The variable may have been left unarchived.
+    update_var_data(editor);
+
+CCDBG_ENDBLOCK();
+
+    return 0;
+  }
+
+CCDBG_ENDBLOCK();
+
+  return 1;
+}
+
+
+static bool patch_var(s_editor* const editor, s_calc_var* const var)
+{
+CCDBG_BEGINBLOCK("patch_var");
+CCDBG_DUMP_UINT(g_num_dirty_ranges);
+
+  bool archived = var->archived;
+  bool retval = false;
+  uint8_t* var_data;
+  uint8_t handle;
+  uint8_t idx;
+  uint24_t end;
+
+  if ((handle = ti_OpenVar(var->name, "r", var->type)))
+  {
+    if (!archived || ti_SetArchiveStatus(false, handle))
+    {
+      // Unarchiving the variable can move the edit buffer in RAM.
+      update_base_address(editor);
+
+      if (
+        hevat_GetVarInfoByNameAndType(
+          var, editor->name, editor->name_length, editor->tios_var_type
+        )
+      )
+      {
+        var_data = var->data + (var->named ? 2 : 0);
+
+        for (idx = 0; idx < g_num_dirty_ranges; idx++)
+        {
+          // Deletions can leave ranges that extend past the end of the data.
+          end = min(g_dirty_ranges[idx].end, editor->data_size);
+
+          if (g_dirty_ranges[idx].start < end)
+          {
+            read_data(
+              editor,
+              g_dirty_ranges[idx].start,
+              var_data + g_dirty_ranges[idx].start,
+              end - g_dirty_ranges[idx].start
+            );
+          }
+        }
+
+        retval = true;
+      }
+      else
+      {
+CCDBG_PUTS("Could not find unarchived variable");
+      }
+
+      if (archived && !ti_SetArchiveStatus(true, handle))
+      {
+CCDBG_PUTS("Could not archive variable");
+        retval = false;
+      }
+    }
+    else
+    {
+CCDBG_PUTS("Could not unarchive variable");
+    }
+
+    ti_Close(handle);
+  }
+
+CCDBG_DUMP_UINT(retval);
+CCDBG_ENDBLOCK();
+
+  return retval;
+}
+
+
+static void mark_dirty(const uint24_t start, const uint24_t end)
+{
+  uint8_t idx = 0;
+  uint8_t closest_idx = 1;
+
+  if (start >= end)
+    return;
+
+  // Insert the new range in order, then merge every range that overlaps or
+  // touches the one before it.
+  while (idx < g_num_dirty_ranges && g_dirty_ranges[idx].start < start)
+    idx++;
+
+  memmove(
+    &g_dirty_ranges[idx + 1],
+    &g_dirty_ranges[idx],
+    (g_num_dirty_ranges - idx) * sizeof(s_dirty_range)
+  );
+  g_dirty_ranges[idx].start = start;
+  g_dirty_ranges[idx].end = end;
+  g_num_dirty_ranges++;
+
+  idx = 1;
+
+  while (idx < g_num_dirty_ranges)
+  {
+    if (g_dirty_ranges[idx].start <= g_dirty_ranges[idx - 1].end)
+      merge_dirty_ranges(idx);
+    else
+      idx++;
+  }
+
+  if (g_num_dirty_ranges > MAX_NUM_DIRTY_RANGES)
+  {
+    for (idx = 2; idx < g_num_dirty_ranges; idx++)
+    {
+      if (
+        g_dirty_ranges[idx].start - g_dirty_ranges[idx - 1].end
+        < g_dirty_ranges[closest_idx].start
+          - g_dirty_ranges[closest_idx - 1].end
+      )
+      {
+        closest_idx = idx;
+      }
+    }
+
+    merge_dirty_ranges(closest_idx);
+  }
+
+  return;
+}
+
+
+static void merge_dirty_ranges(const uint8_t idx)
+{
+  g_dirty_ranges[idx - 1].end = max(
+    g_dirty_ranges[idx - 1].end, g_dirty_ranges[idx].end
+  );
+  g_num_dirty_ranges--;
+  memmove(
+    &g_dirty_ranges[idx],
+    &g_dirty_ranges[idx + 1],
+    (g_num_dirty_ranges - idx) * sizeof(s_dirty_range)
+  );
+  return;
+}
+
+
+static void set_cursor(s_editor* const editor, const uint24_t offset)
+{
+  if (!editor->data_size)
+    editor->near_size = 0;
+  else if (editor->selection_size)
+    editor->near_size = offset + editor->selection_size;
+  else
+    editor->near_size = offset + 1;
+
+  assert(editor->near_size <= editor->data_size);
+
+  editor->far_size = editor->data_size - editor->near_size;
+  return;
+}
+
+
+static uint24_t segment_end(const s_editor* const editor, const uint24_t offset)
+{
+  uint24_t end;
+
+  if (!editor->paged)
+  {
+    if (offset < editor->gap_offset)
+      return editor->gap_offset;
+
+    return editor->data_size;
+  }
+
+  end = (offset / EDIT_PAGE_SIZE + 1) * EDIT_PAGE_SIZE;
+
+  // Modified pages are not stored in order, so each one is its own segment.
+  // Runs of unmodified pages are contiguous in the variable's data.
+  if (!g_page_slots[offset / EDIT_PAGE_SIZE])
+  {
+    while (end < editor->data_size && !g_page_slots[end / EDIT_PAGE_SIZE])
+      end += EDIT_PAGE_SIZE;
+  }
+
+  return min(end, editor->data_size);
+}
+
+
+static bool can_grow_edit_buffer(
+  const s_editor* const editor, const uint24_t size
+)
+{
+  if (size <= editor->buffer_size)
+    return true;
+
+  return (
+    size <= MAX_VAR_DATA_SIZE - other_regions_size()
+    && tool_CheckFreeRAM(size - editor->buffer_size)
+  );
+}
+
+
+static bool grow_edit_buffer(s_editor* const editor, const uint24_t size)
+{
+CCDBG_BEGINBLOCK("grow_edit_buffer");
+CCDBG_DUMP_UINT(editor->buffer_size);
+CCDBG_DUMP_UINT(size);
+
+  bool retval = false;
+  uint24_t new_size = editor->buffer_size * 2;
+  uint24_t old_size = editor->buffer_size;
+
+  if (size <= editor->buffer_size)
+  {
+CCDBG_ENDBLOCK();
+    return true;
+  }
+
+  if (!editor->paged)
+    new_size = max(new_size, editor->data_size + G_EDIT_BUFFER_HEADROOM);
+
+  // The other tabs' regions share the edit buffer's maximum size.
+  new_size = min(
+    max(new_size, size), MAX_VAR_DATA_SIZE - other_regions_size()
+  );
+
+  // Settle for the size that was asked for if there is not enough RAM to grow
+  // any further.
+  if (!tool_CheckFreeRAM(new_size - editor->buffer_size))
+    new_size = size;
+
+  if (can_grow_edit_buffer(editor, new_size))
+    retval = resize_region(editor, new_size);
+
+  if (retval)
+  {
+    // The new bytes are added to the start of the region, so the data before
+    // the gap must be moved back to the start. Page slots are allocated from
+    // the end of the region, so they stay where they are.
+    if (!editor->paged)
+    {
+      asmutil_CopyData(
+        editor->base_address + editor->buffer_size - old_size,
+        editor->base_address,
+        editor->gap_offset,
+        1
+      );
+    }
+
+    // Resizing the edit buffer moves the variables stored after it in RAM.
+    update_var_data(editor);
+  }
+
+CCDBG_DUMP_UINT(editor->buffer_size);
+CCDBG_ENDBLOCK();
+
+  return retval;
+}
+
+
+static bool pages_writable(
+  const s_editor* const editor, const uint24_t offset, const uint24_t amount
+)
+{
+  uint24_t page;
+  uint8_t num_new_pages = 0;
+
+  if (!editor->paged)
+    return true;
+
+  for (
+    page = offset / EDIT_PAGE_SIZE;
+    page <= (offset + amount - 1) / EDIT_PAGE_SIZE;
+    page++
+  )
+  {
+    if (!g_page_slots[page])
+      num_new_pages++;
+  }
+
+  return pages_fit(editor, num_new_pages);
+}
+
+
+static bool pages_fit(
+  const s_editor* const editor, const uint24_t num_new_pages
+)
+{
+  if (!editor->paged)
+    return true;
+
+  return (
+    g_num_pages_loaded + num_new_pages <= UINT8_MAX
+    && can_grow_edit_buffer(
+      editor, (g_num_pages_loaded + num_new_pages) * EDIT_PAGE_SIZE
+    )
+  );
+}
+
+
+static void count_new_pages(
+  const uint24_t offset,
+  const uint24_t amount,
+  uint24_t* const next_page,
+  uint24_t* const num_new_pages
+)
+{
+  uint24_t page = max(offset / EDIT_PAGE_SIZE, *next_page);
+
+  for (; page <= (offset + amount - 1) / EDIT_PAGE_SIZE; page++)
+  {
+    if (!g_page_slots[page])
+      (*num_new_pages)++;
+  }
+
+  *next_page = page;
+  return;
+}
+
+
+static void load_pages(
+  s_editor* const editor, const uint24_t offset, const uint24_t amount
+)
+{
+  uint24_t page;
+  uint8_t num_new_pages = 0;
+
+  if (!editor->paged || editor->in_place)
+    return;
+
+  assert(pages_writable(editor, offset, amount));
+
+  for (
+    page = offset / EDIT_PAGE_SIZE;
+    page <= (offset + amount - 1) / EDIT_PAGE_SIZE;
+    page++
+  )
+  {
+    if (!g_page_slots[page])
+      num_new_pages++;
+  }
+
+  if (g_num_pages_loaded + num_new_pages > g_num_page_slots)
+  {
+    grow_edit_buffer(
+      editor, (g_num_pages_loaded + num_new_pages) * EDIT_PAGE_SIZE
+    );
+  }
+
+  for (
+    page = offset / EDIT_PAGE_SIZE;
+    page <= (offset + amount - 1) / EDIT_PAGE_SIZE;
+    page++
+  )
+  {
+    if (!g_page_slots[page])
+    {
+      g_page_slots[page] = ++g_num_pages_loaded;
+      asmutil_CopyData(
+        editor->var_data + page * EDIT_PAGE_SIZE,
+        tool_DataPtr(editor, page * EDIT_PAGE_SIZE),
+        min(EDIT_PAGE_SIZE, editor->data_size - page * EDIT_PAGE_SIZE),
+        1
+      );
+    }
+  }
+
+  return;
+}
+
+
+static bool can_unpage(const s_editor* const editor)
+{
+  if (!editor->paged)
+    return true;
+
+  return can_grow_edit_buffer(
+    editor, editor->data_size + (g_num_pages_loaded * EDIT_PAGE_SIZE)
+  );
+}
+
+
+static void unpage_data(s_editor* const editor)
+{
+  if (!editor->paged)
+    return;
+
+  assert(can_unpage(editor));
+
+  grow_edit_buffer(
+    editor, editor->data_size + (g_num_pages_loaded * EDIT_PAGE_SIZE)
+  );
+
+  // The modified pages are stored at the end of the edit buffer, so copying
+  // the data to its start cannot overwrite a page before it is read.
+  read_data(editor, 0, editor->base_address, editor->data_size);
+
+  // The edit buffer now holds the changes, so the variable can go back to its
+  // original state until the changes are saved.
+  if (editor->in_place)
+  {
+    revert_in_place_edits(
+      editor->var_data, g_undo_sp + 1, g_undo_top + 1, g_undo_offset
+    );
+    end_journal(editor);
+  }
+
+  editor->paged = false;
+  editor->in_place = false;
+  editor->gap_offset = editor->data_size;
+  return;
+}
+
+
+static void revert_in_place_edits(
+  uint8_t* const var_data,
+  uint8_t* record,
+  const uint8_t* const end,
+  uint24_t offset
+)
+{
+CCDBG_BEGINBLOCK("revert_in_place_edits");
+
+  const s_replace_header* replace;
+  const uint8_t* gap;
+  uint8_t* payload;
+  uint24_t num_bytes;
+  uint24_t match;
+  uint24_t idx;
+
+  // Only overwriting records can be made while editing in place, except for
+  // the resizing record pushed just before the data is unpaged. A run's old
+  // values are the bytes' values before the run first changed them, so whole
+  // bytes are restored even for nibble runs.
+  while (record < end)
+  {
+    payload = record + undo_header_size(record);
+    num_bytes = undo_record_size(record) - undo_header_size(record);
+
+    switch (*record)
+    {
+      case UNDO_WRITE_HIGH_NIBBLES:
+      case UNDO_WRITE_LOW_NIBBLES:
+      case UNDO_WRITE_BYTES:
+        for (idx = 0; idx < num_bytes; idx++)
+          var_data[offset + num_bytes - 1 - idx] = payload[idx];
+        break;
+
+      case UNDO_PASTE_BYTES:
+        asmutil_CopyData(payload, var_data + offset, num_bytes, 1);
+        break;
+
+      case UNDO_INSERT_BYTES:
+      case UNDO_DELETE_OR_CUT_BYTES:
+        break;
+
+      case UNDO_REPLACE_BYTES:
+        replace = (const s_replace_header*)payload;
+
+        if (replace->replacement_length != record[1])
+          break;
+
+        gap = payload + sizeof *replace + 2 * record[1];
+        match = offset;
+
+        for (idx = 0; idx < replace->num_matches; idx++)
+        {
+          if (idx)
+            match += record[1] + read_replace_gap(&gap);
+
+          asmutil_CopyData(
+            payload + sizeof *replace, var_data + match, record[1], 1
+          );
+        }
+        break;
+
+      default:
+        assert(false);
+CCDBG_ENDBLOCK();
+        return;
+    }
+
+    offset -= undo_delta(record);
+    record += undo_record_size(record);
+  }
+
+CCDBG_ENDBLOCK();
+  return;
+}
+
+
+static void journal_name(const uint8_t journal, char name[9])
+{
+  strcpy(name, G_JOURNAL_APPVAR_NAME);
+  name[7] = '0' + journal;
+  return;
+}
+
+
+static bool read_journal_footer(
+  const uint8_t handle, s_journal_footer* const footer
+)
+{
+  uint24_t size = ti_GetSize(handle);
+
+  if (size < sizeof *footer)
+    return false;
+
+  memcpy(
+    footer, (uint8_t*)ti_GetDataPtr(handle) + size - sizeof *footer,
+    sizeof *footer
+  );
+
+  return true;
+}
+
+
+static bool journal_in_use(const uint8_t journal)
+{
+  for (uint8_t tab = 0; tab < g_num_tabs; tab++)
+  {
+    if (g_tabs[tab].journal == journal)
+      return true;
+  }
+
+  return false;
+}
+
+
+static uint24_t count_undo_changes(uint8_t* record, const uint8_t* const end)
+{
+  uint24_t num_changes = 0;
+
+  // Each nibble or byte of a run was written by its own keystroke.
+  while (record < end)
+  {
+    if (
+      record[0] == UNDO_WRITE_HIGH_NIBBLES
+      || record[0] == UNDO_WRITE_LOW_NIBBLES
+      || record[0] == UNDO_WRITE_BYTES
+    )
+      num_changes += record[1];
+    else
+      num_changes++;
+
+    record += undo_record_size(record);
+  }
+
+  return num_changes;
+}
+
+
+static void start_journal(s_editor* const editor)
+{
+CCDBG_BEGINBLOCK("start_journal");
+
+  s_tab* const tab = &g_tabs[g_active_tab];
+  s_journal_footer footer;
+  s_journal_footer leftover;
+  uint24_t size;
+  uint8_t* data;
+  char name[9];
+  uint8_t journal;
+  uint8_t handle;
+
+  tab->journal = NO_JOURNAL;
+  tab->journal_synced = 0;
+  tab->journal_size = 0;
+  tab->journal_pending = 0;
+
+  footer.undo_offset = 0;
+  footer.var_size = editor->data_size;
+  footer.var_type = editor->tios_var_type;
+  footer.name_length = editor->name_length;
+  memcpy(footer.name, editor->name, sizeof footer.name);
+
+  // A journal left by a session that did not end normally is taken over, along
+  // with its undo records, if it belongs to this variable. Otherwise, the
+  // first journal that is neither in use nor left over is started.
+  for (journal = 0; journal < G_MAX_NUM_TABS; journal++)
+  {
+    if (journal_in_use(journal))
+      continue;
+
+    journal_name(journal, name);
+
+    if (!(handle = ti_Open(name, "r")))
+    {
+      if (tab->journal == NO_JOURNAL)
+        tab->journal = journal;
+
+      continue;
+    }
+
+    size = ti_GetSize(handle) - sizeof footer;
+    data = ti_GetDataPtr(handle);
+
+    if (!read_journal_footer(handle, &leftover))
+    {
+      if (tab->journal == NO_JOURNAL)
+        tab->journal = journal;
+    }
+    else if (
+      leftover.var_size == footer.var_size
+      && leftover.var_type == footer.var_type
+      && leftover.name_length == footer.name_length
+      && !memcmp(leftover.name, footer.name, footer.name_length)
+      && size <= (uint24_t)(g_undo_top - g_redo_sp)
+    )
+    {
+      g_undo_sp = g_undo_top - size;
+      memcpy(g_undo_sp + 1, data, size);
+      g_undo_offset = leftover.undo_offset;
+      editor->num_changes = count_undo_changes(g_undo_sp + 1, g_undo_top + 1);
+
+      tab->journal = journal;
+      tab->journal_synced = size;
+      tab->journal_size = size;
+      ti_Close(handle);
+
+CCDBG_PUTS("Took over journal.");
+CCDBG_DUMP_UINT(journal);
+CCDBG_ENDBLOCK();
+      return;
+    }
+
+    ti_Close(handle);
+  }
+
+  if (tab->journal == NO_JOURNAL)
+  {
+CCDBG_PUTS("No free journal.");
+CCDBG_ENDBLOCK();
+    return;
+  }
+
+  journal_name(tab->journal, name);
+
+  if (
+    !(handle = ti_Open(name, "w"))
+    || ti_Resize(sizeof footer, handle) <= 0
+    || ti_GetSize(handle) != sizeof footer
+  )
+  {
+    // Editing in place does not depend on the journal.
+    tab->journal = NO_JOURNAL;
+  }
+  else
+    ti_Write(&footer, sizeof footer, 1, handle);
+
+  if (handle)
+    ti_Close(handle);
+
+  update_base_address(editor);
+  update_var_data(editor);
+
+CCDBG_DUMP_UINT(tab->journal);
+CCDBG_ENDBLOCK();
+  return;
+}
+
+
+static void sync_journal(s_editor* const editor, const bool force)
+{
+  s_tab* const tab = &g_tabs[g_active_tab];
+  uint24_t undo_size = g_undo_top - g_undo_sp;
+  uint8_t* data;
+  char name[9];
+  uint8_t handle;
+
+  if (tab->journal == NO_JOURNAL || !editor->in_place)
+    return;
+
+  if (!force && ++tab->journal_pending < JOURNAL_BATCH_SIZE)
+    return;
+
+  tab->journal_pending = 0;
+
+  if (tab->journal_synced == undo_size && tab->journal_size == undo_size)
+    return;
+
+  journal_name(tab->journal, name);
+
+  if (!(handle = ti_Open(name, "r+")))
+    return;
+
+  // The journal is left as it was if it cannot be resized, and the unsynced
+  // records are copied the next time.
+  ti_Resize(undo_size + sizeof(s_journal_footer), handle);
+
+  if (ti_GetSize(handle) == undo_size + sizeof(s_journal_footer))
+  {
+    data = ti_GetDataPtr(handle);
+    memcpy(data, g_undo_sp + 1, undo_size - tab->journal_synced);
+    memcpy(data + undo_size, &g_undo_offset, sizeof(uint24_t));
+    tab->journal_synced = undo_size;
+    tab->journal_size = undo_size;
+  }
+
+  ti_Close(handle);
+  update_base_address(editor);
+  update_var_data(editor);
+  return;
+}
+
+
+static void unsync_journal_top(void)
+{
+  s_tab* const tab = &g_tabs[g_active_tab];
+  uint24_t size = g_undo_top - g_undo_sp - undo_record_size(g_undo_sp + 1);
+
+  tab->journal_synced = min(tab->journal_synced, size);
+  return;
+}
+
+
+static void end_journal(s_editor* const editor)
+{
+  s_tab* const tab = &g_tabs[g_active_tab];
+  char name[9];
+  uint8_t handle;
+
+  if (tab->journal == NO_JOURNAL)
+    return;
+
+  // The journal is emptied rather than deleted, because deleting a variable
+  // moves the entries that the HEVAT points to. Empty journals are deleted
+  // when HexaEdit exits.
+  journal_name(tab->journal, name);
+
+  if ((handle = ti_Open(name, "w")))
+    ti_Close(handle);
+
+  tab->journal = NO_JOURNAL;
+  update_base_address(editor);
+  update_var_data(editor);
+  return;
+}
+
+
+static void spill_name(const uint8_t spill, char name[9])
+{
+  strcpy(name, G_SPILL_APPVAR_NAME);
+  name[7] = '0' + spill;
+  return;
+}
+
+
+static uint8_t pack_bytes(
+  const uint8_t* src, const uint8_t size, uint8_t* dest
+)
+{
+  const uint8_t* const end = src + size;
+  const uint8_t* const dest_end = dest + size;
+  uint8_t* const start = dest;
+  uint8_t* literals = NULL;
+  uint8_t run;
+
+  // Each block starts with a control byte. A control byte of 128 or more
+  // repeats the next byte (control - 125) times, and any other is followed by
+  // (control + 1) bytes to copy.
+  while (src < end)
+  {
+    for (run = 1; src + run < end && src[run] == *src && run < 130; run++);
+
+    if (run >= 3)
+    {
+      if (dest + 2 > dest_end)
+        return 0;
+
+      *dest++ = run + 125;
+      *dest++ = *src;
+      src += run;
+      literals = NULL;
+      continue;
+    }
+
+    if (!literals || *literals == 127)
+    {
+      if (dest + 2 > dest_end)
+        return 0;
+
+      literals = dest++;
+      *literals = 0;
+    }
+    else
+    {
+      if (dest + 1 > dest_end)
+        return 0;
+
+      (*literals)++;
+    }
+
+    *dest++ = *src++;
+  }
+
+  return (dest < dest_end ? dest - start : 0);
+}
+
+
+static void unpack_bytes(const uint8_t* src, uint8_t* dest, uint8_t size)
+{
+  uint8_t control;
+  uint8_t num;
+
+  while (size)
+  {
+    control = *src++;
+
+    if (control >= 128)
+    {
+      num = control - 125;
+      memset(dest, *src++, num);
+    }
+    else
+    {
+      num = control + 1;
+      memcpy(dest, src, num);
+      src += num;
+    }
+
+    dest += num;
+    size -= num;
+  }
+
+  return;
+}
+
+
+static bool spill_undo_record(s_editor* const editor, const uint8_t code)
+{
+  s_tab* const tab = &g_tabs[g_active_tab];
+  uint24_t offset = editor->near_size - editor->selection_size;
+  uint8_t stored_size = editor->selection_size;
+  uint8_t* stored = g_spill_bytes;
+  uint8_t* payload;
+  uint8_t spill;
+  uint8_t idx;
+  uint24_t size;
+  char name[9];
+  uint8_t handle;
+  bool spilled = false;
+
+  // Paged data may still need the free RAM to make the change, and in-place
+  // edits are reverted and journaled straight from the undo stack.
+  if (editor->paged || editor->selection_size < UNDO_SPILL_SIZE)
+    return false;
+
+  if (tab->spill == NO_SPILL)
+  {
+    for (spill = 0; spill < G_MAX_NUM_TABS; spill++)
+    {
+      for (idx = 0; idx < g_num_tabs; idx++)
+      {
+        if (g_tabs[idx].spill == spill)
+          break;
+      }
+
+      if (idx == g_num_tabs)
+        break;
+    }
+
+    // A leftover spill appvar is emptied.
+    spill_name(spill, name);
+
+    if (!(handle = ti_Open(name, "w")))
+      return false;
+
+    ti_Close(handle);
+    tab->spill = spill;
+  }
+
+  read_data(editor, offset, g_spill_bytes, editor->selection_size);
+
+  if (
+    (size = pack_bytes(g_spill_bytes, editor->selection_size, g_spill_packed))
+  )
+  {
+    stored_size = size;
+    stored = g_spill_packed;
+  }
+
+  // Adding the record may evict older ones and shrink the spill appvar.
+  if (
+    !(payload = push_undo_record(
+      editor,
+      code == UNDO_PASTE_BYTES
+      ? UNDO_PASTE_SPILLED_BYTES
+      : UNDO_DELETE_OR_CUT_SPILLED_BYTES,
+      editor->selection_size,
+      offset,
+      1
+    ))
+  )
+  {
+    return false;
+  }
+
+  *payload = stored_size;
+  spill_name(tab->spill, name);
+
+  if ((handle = ti_Open(name, "r+")))
+  {
+    size = ti_GetSize(handle);
+    ti_Resize(size + stored_size, handle);
+
+    if (ti_GetSize(handle) == size + stored_size)
+    {
+      memcpy(ti_GetDataPtr(handle), stored, stored_size);
+      spilled = true;
+    }
+
+    ti_Close(handle);
+  }
+
+  // The old bytes are kept in the undo stack after all.
+  if (!spilled)
+    pop_undo_record();
+
+  update_base_address(editor);
+  update_var_data(editor);
+  return spilled;
+}
+
+
+static void unspill_bytes(
+  s_editor* const editor, const uint8_t* const record, uint8_t* const dest
+)
+{
+  uint8_t stored_size = record[undo_header_size(record)];
+  char name[9];
+  uint8_t handle;
+  uint8_t* data;
+
+  spill_name(g_tabs[g_active_tab].spill, name);
+  handle = ti_Open(name, "r+");
+  assert(handle && ti_GetSize(handle) >= stored_size);
+  data = ti_GetDataPtr(handle);
+
+  if (stored_size == record[1])
+    memcpy(dest, data, stored_size);
+  else
+    unpack_bytes(data, dest, record[1]);
+
+  ti_Resize(ti_GetSize(handle) - stored_size, handle);
+  ti_Close(handle);
+  update_base_address(editor);
+  update_var_data(editor);
+  return;
+}
+
+
+static void drop_spilled_bytes(s_editor* const editor, const uint24_t size)
+{
+  char name[9];
+  uint8_t handle;
+  uint8_t* data;
+  uint24_t spill_size;
+
+  if (!size)
+    return;
+
+  spill_name(g_tabs[g_active_tab].spill, name);
+  handle = ti_Open(name, "r+");
+  assert(handle && ti_GetSize(handle) >= size);
+
+  // Resizing removes bytes from the start, so the newer bytes are moved over
+  // the evicted ones first.
+  data = ti_GetDataPtr(handle);
+  spill_size = ti_GetSize(handle);
+  memmove(data + size, data, spill_size - size);
+  ti_Resize(spill_size - size, handle);
+  ti_Close(handle);
+  update_base_address(editor);
+  update_var_data(editor);
+  return;
+}
+
+
+static void end_spill(s_editor* const editor)
+{
+  s_tab* const tab = &g_tabs[g_active_tab];
+  char name[9];
+  uint8_t handle;
+
+  if (tab->spill == NO_SPILL)
+    return;
+
+  // Like a journal, the spill appvar is emptied rather than deleted.
+  spill_name(tab->spill, name);
+
+  if ((handle = ti_Open(name, "w")))
+    ti_Close(handle);
+
+  tab->spill = NO_SPILL;
+  update_base_address(editor);
+  update_var_data(editor);
+  return;
+}
+
+
+static bool add_signature(const uint8_t signature[], const uint8_t length)
+{
+  uint8_t node = 0;
+  uint8_t child;
+  uint8_t idx = 0;
+
+  // The signature's bytes are followed as far as the tree already has them.
+  while (idx < length)
+  {
+    child = g_signature_nodes[node].child;
+
+    while (child && g_signature_nodes[child].byte != signature[idx])
+      child = g_signature_nodes[child].sibling;
+
+    if (!child)
+      break;
+
+    node = child;
+    idx++;
+  }
+
+  if (length - idx > MAX_NUM_SIGNATURE_NODES - g_num_signature_nodes)
+    return false;
+
+  for (; idx < length; idx++)
+  {
+    child = g_num_signature_nodes++;
+    memset(&g_signature_nodes[child], 0, sizeof(s_signature_node));
+    g_signature_nodes[child].byte = signature[idx];
+    g_signature_nodes[child].sibling = g_signature_nodes[node].child;
+    g_signature_nodes[node].child = child;
+    node = child;
+  }
+
+  // A repeated signature is reported as the first one.
+  if (!g_signature_nodes[node].signature)
+    g_signature_nodes[node].signature = g_num_signatures + 1;
+
+  return true;
+}
+
+
+static void link_signature_nodes(void)
+{
+  uint8_t queue[MAX_NUM_SIGNATURE_NODES];
+  uint8_t head = 0;
+  uint8_t tail = 0;
+  uint8_t node;
+  uint8_t child;
+  uint8_t fail;
+
+  memset(g_signature_root, 0, sizeof g_signature_root);
+
+  for (
+    child = g_signature_nodes[0].child;
+    child;
+    child = g_signature_nodes[child].sibling
+  )
+  {
+    g_signature_root[g_signature_nodes[child].byte] = child;
+    queue[tail++] = child;
+  }
+
+  // The nodes are linked in order of depth, so each node's <fail> node, which
+  // is shallower, is linked before it.
+  while (head < tail)
+  {
+    node = queue[head++];
+
+    for (
+      child = g_signature_nodes[node].child;
+      child;
+      child = g_signature_nodes[child].sibling
+    )
+    {
+      fail = next_signature_node(
+        g_signature_nodes[node].fail, g_signature_nodes[child].byte
+      );
+      g_signature_nodes[child].fail = fail;
+
+      if (g_signature_nodes[fail].signature)
+        g_signature_nodes[child].output = fail;
+      else
+        g_signature_nodes[child].output = g_signature_nodes[fail].output;
+
+      queue[tail++] = child;
+    }
+  }
+
+  return;
+}
+
+
+static uint8_t next_signature_node(uint8_t node, const uint8_t byte)
+{
+  uint8_t child;
+
+  while (node)
+  {
+    for (
+      child = g_signature_nodes[node].child;
+      child;
+      child = g_signature_nodes[child].sibling
+    )
+    {
+      if (g_signature_nodes[child].byte == byte)
+        return child;
+    }
+
+    node = g_signature_nodes[node].fail;
+  }
+
+  return g_signature_root[byte];
+}
+
+
+static void add_signature_hit(const uint24_t offset, const uint8_t signature)
+{
+  uint8_t idx = g_num_signature_hits;
+
+  if (g_num_signature_hits == MAX_NUM_SIGNATURE_HITS)
+    return;
+
+  // Hits are found in order of where they end, so a hit only moves past the
+  // few earlier hits of longer signatures that end after it starts.
+  while (idx && g_signature_hits[idx - 1].offset > offset)
+  {
+    g_signature_hits[idx] = g_signature_hits[idx - 1];
+    idx--;
+  }
+
+  g_signature_hits[idx].offset = offset;
+  g_signature_hits[idx].signature = signature;
+  g_num_signature_hits++;
+  return;
+}
+
+
+static uint24_t search_segment(
+  const s_editor* const editor, uint24_t* const offset
+)
+{
+  if (!is_ports_editor(editor))
+    return segment_end(editor, *offset);
+
+  for (uint8_t idx = 0; idx < NUM_PORT_RANGES; idx++)
+  {
+    if (
+      PORT_RANGES[idx].access == PORT_READ_SAFE
+      && PORT_RANGES[idx].end > *offset
+    )
+    {
+      *offset = max(*offset, PORT_RANGES[idx].start);
+      return PORT_RANGES[idx].end;
+    }
+  }
+
+  *offset = editor->data_size;
+  return editor->data_size;
+}
+
+
+static bool is_ports_editor(const s_editor* const editor)
+{
+  return (
+    !editor->is_tios_var && editor->base_address == G_PORTS_BASE_ADDRESS
+  );
+}
+
+
+static bool is_ram_editor(const s_editor* const editor)
+{
+  return (
+    !editor->is_tios_var && editor->base_address == G_RAM_BASE_ADDRESS
+  );
+}
+
+
+static uint8_t port_access(const uint24_t offset)
+{
+  for (uint8_t idx = 0; idx < NUM_PORT_RANGES; idx++)
+  {
+    if (offset < PORT_RANGES[idx].start)
+      break;
+
+    if (offset < PORT_RANGES[idx].end)
+      return PORT_RANGES[idx].access;
+  }
+
+  return PORT_UNMAPPED;
+}
+
+
+static bool ports_accessible(
+  const s_editor* const editor,
+  const uint24_t offset,
+  const uint24_t amount,
+  const bool write
+)
+{
+  uint8_t access;
+
+  if (!is_ports_editor(editor))
+    return true;
+
+  if (write && g_ports_snapshot_active)
+    return false;
+
+  for (uint24_t idx = 0; idx < amount; idx++)
+  {
+    access = port_access(offset + idx);
+
+    if (
+      access != PORT_READ_SAFE
+      && !(write && access == PORT_WRITE_ONLY)
+    )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
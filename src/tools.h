@@ -45,6 +45,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "defines.h"
 
 
+// How the bytes in a range of the ports region can be accessed.
+enum PORT_ACCESS : uint8_t
+{
+  PORT_UNMAPPED,
+  PORT_READ_SAFE,
+  PORT_READ_SIDE_EFFECTS,
+  PORT_WRITE_ONLY
+};
+
+
 void tool_FatalErrorExit(void);
 
 
@@ -57,14 +67,63 @@ void tool_InitUndoStack(void);
 bool tool_CreateRecentsAppvar(void);
 
 
+// Description: Creates an empty edit buffer, or empties the existing one. The
+//              edit buffer grows as the editor needs it, so it only holds RAM
+//              while a variable is being resized or its pages are modified.
+// Post:        <editor->base_address> and <editor->buffer_size> set.
 bool tool_CreateEditBuffer(s_editor* const editor);
 
 
+// Description: Opens a new tab with an empty region of the edit buffer and an
+//              equal share of the undo stack, and makes it the active tab.
+//              The other tabs' undo stack shares shrink to make room.
+// Post:        If successful, true returned and <editor->base_address> and
+//              <editor->buffer_size> set.
+//              If there are already G_MAX_NUM_TABS tabs, or another tab's undo
+//              records do not fit in its smaller share, false returned.
+bool tool_OpenTab(s_editor* const editor);
+
+
+// Description: Closes the active tab, discarding its region of the edit buffer
+//              and its undo records. If any tabs are left, the tab before it
+//              is made active.
+// Pre:         <editor> must be the active tab's editor.
+// Post:        tool_SwitchTab() must be called with the new active tab's
+//              editor.
+void tool_CloseTab(s_editor* const editor);
+
+
+// Description: Makes <tab> the active tab. Nothing is copied, so switching is
+//              instant.
+// Pre:         <editor> must be <tab>'s editor.
+// Post:        <editor->base_address>, <editor->buffer_size>, and
+//              <editor->var_data> updated.
+void tool_SwitchTab(s_editor* const editor, const uint8_t tab);
+
+
+uint8_t tool_NumTabs(void);
+
+
+uint8_t tool_ActiveTab(void);
+
+
 // Post: If successful, pointer returned and <size> set to buffer size.
 //       Otherwise, NULL returned and <size> is undefined.
 void* tool_EditBufferPtr(uint24_t* size);
 
 
+// Description: Returns the largest size the edit buffer can grow to with the
+//              RAM that is currently free.
+uint24_t tool_EditBufferCapacity(void);
+
+
+// Description: Translates a logical data offset into the address of that byte
+//              in the editor's buffer, skipping over the gap.
+// Pre:         <offset> must be less than or equal to <editor->data_size>.
+// Post:        Pointer to the byte at <offset> returned.
+uint8_t* tool_DataPtr(const s_editor* const editor, const uint24_t offset);
+
+
 bool tool_CheckFreeRAM(const uint24_t amt);
 
 
@@ -74,13 +133,28 @@ bool tool_CheckFreeRAM(const uint24_t amt);
 int8_t tool_SaveModifiedVar(s_editor* const editor);
 
 
+// Description: Returns how many more bytes of RAM must be freed before the
+//              editor's variable can be saved, or zero if none. Saving a paged
+//              variable that is archived unarchives all of it, after the page
+//              slots that the edit buffer does not use are given back.
+uint24_t tool_SaveRAMShortfall(const s_editor* const editor);
+
+
+// Description: Opens <data> for paged editing. Nothing is copied until a page
+//              is modified, so <size> may exceed <editor->buffer_size>.
+//              Paged data is copied into the edit buffer in full the first
+//              time it is resized, which requires enough free RAM for the
+//              edit buffer to grow to hold it.
+//              If <in_place> is true, <data> must be in RAM, and pages are
+//              modified where they are instead of being copied.
 // Pre:  <editor->base_address> and <editor->buffer_size>
 // Post: <editor->data_size>, <editor->near_size>, and <editor->far_size> set.
-bool tool_BufferVarData(
+bool tool_PageVarData(
   s_editor* const editor,
   void* data,
   const uint24_t size,
-  const uint24_t offset
+  const uint24_t offset,
+  const bool in_place
 );
 
 
@@ -95,6 +169,34 @@ void tool_LoadEditBufferIntoVar(
 void tool_DeleteEditBuffer(void);
 
 
+// Description: Copies the active tab's undo records into its journal, if it
+//              keeps one. Called whenever the tab stops being shown.
+void tool_SyncJournal(s_editor* const editor);
+
+
+// Description: Looks for the variable whose in-place edits journal <journal>
+//              recorded before HexaEdit last failed to exit normally.
+// Post:        If the variable is found, its VAT pointer is written to <vatptr>
+//              and true returned. Otherwise, the journal is deleted and false
+//              returned.
+bool tool_GetJournalVar(const uint8_t journal, void** const vatptr);
+
+
+// Description: Undoes the in-place edits recorded by journal <journal> and
+//              deletes it.
+// Pre:         tool_GetJournalVar() must be true for <journal>.
+void tool_RollBackJournal(const uint8_t journal);
+
+
+// Description: Deletes journal <journal>, keeping the edits it recorded.
+void tool_DeleteJournal(const uint8_t journal);
+
+
+// Description: Deletes every journal.
+// Pre:         No tab may be open.
+void tool_DeleteJournals(void);
+
+
 // Description: Determines based on the editor's state if a tool can be used.
 // Pre:         Pointer to tool must be valid.
 // Post:        If tool can be used, true returned.
@@ -104,6 +206,8 @@ bool tool_IsAvailable(const s_editor* const editor, void* const tool_func_ptr);
 
 // Description: <direction> == 0 decreases the size of the near buffer.
 //              <direction> == 1 increases the size of the near buffer.
+//              Only the cursor moves; the gap in the edit buffer is relocated
+//              lazily, and only by the tools that change the data's size.
 void tool_MoveCursor(
   s_editor* const editor, const uint8_t direction, const uint24_t amt
 );
@@ -124,6 +228,12 @@ void tool_WriteByte(s_editor* const editor, uint8_t byte);
 void tool_Goto(s_editor* const editor, uint24_t offset);
 
 
+// Description: Returns true if all <num> bytes can be inserted at the cursor.
+bool tool_CanInsertBytes(const s_editor* const editor, const uint24_t num);
+
+
+// Description: Inserts <num> bytes of 0x00 before the byte at the cursor. If
+//              the edit buffer cannot hold all of them, none are inserted.
 void tool_InsertBytes(s_editor* const editor, const uint24_t num);
 
 
@@ -139,21 +249,143 @@ void tool_CutBytes(s_editor* const editor);
 void tool_PasteBytes(s_editor* const editor);
 
 
-void tool_FindPhrase(
+// Description: Finds the first occurance of <phrase> that starts at or after
+//              <offset>, or the last one that starts at or before <offset> if
+//              <forward> is false. Matches may overlap, so the next match is
+//              found by searching from one byte past the current one. If
+//              <mask> is not NULL, clear bits in it are wildcards.
+// Pre:         <length> must be at least two.
+//              If there is a <mask>, <phrase> must already be ANDed with it.
+// Post:        If a match was found, true returned and its offset written to
+//              <match>.
+bool tool_FindNextPhrase(
+  const s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  uint24_t offset,
+  const bool forward,
+  uint24_t* const match
+);
+
+
+// Description: Finds the first occurance of <phrase> that starts from <offset>
+//              to <last>, so a long search can be done a part at a time.
+// Pre:         Same as tool_FindNextPhrase().
+// Post:        If a match was found, true returned and its offset written to
+//              <match>.
+bool tool_FindPhraseInRange(
+  const s_editor* const editor,
+  const uint8_t phrase[],
+  const uint8_t mask[],
+  const uint8_t length,
+  const uint24_t offset,
+  const uint24_t last,
+  uint24_t* const match
+);
+
+
+// Description: Replaces every occurance of <phrase> that starts from <offset>
+//              to <last> with <replacement>, which may have a different length.
+//              Matches do not overlap. The replacement is one change, which is
+//              undone all at once.
+// Pre:         tool_IsAvailable(editor, &tool_ReplacePhrase) must be true.
+//              <length> must be at least two, and <replacement_length> at
+//              least one.
+// Post:        The number of matches replaced returned, and the cursor is on
+//              the first one. If there was no match, or the replacement or its
+//              undo record would not fit, zero returned and nothing changed.
+uint24_t tool_ReplacePhrase(
   s_editor* const editor,
   const uint8_t phrase[],
   const uint8_t length,
-  uint24_t matches[],
-  uint8_t* num_matches
+  const uint8_t replacement[],
+  const uint8_t replacement_length,
+  uint24_t offset,
+  uint24_t last
+);
+
+
+// Description: Reads the signatures appvar and builds the automaton that
+//              tool_FindSignatures() uses to find all of them at once. The
+//              appvar holds each signature's length, from 1 to 16, followed by
+//              its bytes. Up to 16 signatures are read, and reading stops at a
+//              length of zero.
+// Post:        The number of signatures read returned. Zero is returned if the
+//              appvar does not exist.
+uint8_t tool_LoadSignatures(void);
+
+
+// Description: Builds the automaton from the <size> bytes of signatures at
+//              <data>, which are laid out the same way as in the signatures
+//              appvar.
+// Post:        The number of signatures read returned.
+uint8_t tool_SetSignatures(const uint8_t data[], const uint24_t size);
+
+
+// Description: Finds every hit of the signatures that tool_LoadSignatures()
+//              read, in one pass over <editor>'s data. The first 255 hits are
+//              kept in order of offset. Hits of different signatures may
+//              overlap.
+// Post:        The number of hits returned, including those that were not
+//              kept.
+uint24_t tool_FindSignatures(const s_editor* const editor);
+
+
+// Description: Returns the number of hits that the last tool_FindSignatures()
+//              kept.
+uint8_t tool_NumSignatureHits(void);
+
+
+// Description: Returns the offset of kept hit number <hit>, and writes the
+//              number of its signature, from one, and the signature's length.
+// Pre:         <hit> must be less than tool_NumSignatureHits().
+uint24_t tool_SignatureHit(
+  const uint8_t hit, uint8_t* const signature, uint8_t* const length
+);
+
+
+// Description: Returns how the byte at <offset> can be accessed, as one of
+//              PORT_ACCESS. Only the ports editor has bytes that are not
+//              PORT_READ_SAFE.
+uint8_t tool_PortAccess(const s_editor* const editor, const uint24_t offset);
+
+
+// Description: Reads the byte at <offset> to show it. In the ports editor, the
+//              bytes in the ports snapshot are shown while it is active, and
+//              the ports that are not safe to read are only shown from it.
+// Post:        False returned if the byte cannot be shown.
+bool tool_ViewByte(
+  const s_editor* const editor, const uint24_t offset, uint8_t* const value
 );
 
 
+// Description: Reads the bytes onscreen in the ports editor once, including the
+//              ports with side effects, and shows them instead of the ports
+//              until the snapshot is taken again or ended. Nothing can be
+//              written while it is shown.
+// Pre:         tool_IsAvailable(editor, &tool_TakePortsSnapshot) must be true.
+void tool_TakePortsSnapshot(const s_editor* const editor);
+
+
+void tool_EndPortsSnapshot(void);
+
+
+bool tool_PortsSnapshotActive(const s_editor* const editor);
+
+
 void tool_SwitchWritingMode(s_editor* const editor);
 
 
 void tool_UndoLastAction(s_editor* const editor);
 
 
+// Description: Re-applies the last change undone by tool_UndoLastAction().
+//              Making any other change discards the changes that could be
+//              redone.
+void tool_RedoLastAction(s_editor* const editor);
+
+
 void tool_AddUndo_WriteNibble(s_editor* const editor);
 
 